@@ -0,0 +1,267 @@
+#include "stdafx.h"
+#include "Autotuner.h"
+#include "Functions.h"
+#include "GenerationOperators.h"
+#include "PipelinedExecutor.h"
+#include "Population.h"
+#include "RandomNumberGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// Points of both sets together the strategies are timed on, larger sets are sampled with a stride
+const int maxProfilePoints = 20000;
+
+// Timed generations per candidate after one warm-up generation, the fastest one counts
+const int profileRepetitions = 3;
+
+bool parseTuneChoice(const std::string &text, TuneChoice &choice)
+{
+	std::string name = text.substr(0, text.find(':'));
+	if (name != "scalar" && name != "mixed")
+		return false;
+
+	choice.useMixedPrecision = name == "mixed";
+	choice.pipelineThreads = 0;
+	choice.seconds = 0.0;
+	if (text.find(':') != std::string::npos)
+	{
+		std::istringstream threads(text.substr(text.find(':') + 1));
+		if (!(threads >> choice.pipelineThreads) || choice.pipelineThreads < 0)
+			return false;
+	}
+	return true;
+}
+
+std::string getTuneChoiceName(const TuneChoice &choice)
+{
+	return std::string(choice.useMixedPrecision ? "mixed" : "scalar") + ":" + std::to_string(choice.pipelineThreads);
+}
+
+// Smallest power of two not below the value
+int roundUpToPowerOfTwo(int value)
+{
+	int power = 1;
+	while (power < value)
+		power <<= 1;
+	return power;
+}
+
+std::string getTuneKey(const RunConfig &config, const PointSet &positiveSet, const PointSet &negativeSet)
+{
+	std::string host = "unknown";
+#ifdef _WIN32
+	if (const char *name = std::getenv("COMPUTERNAME"))
+		host = name;
+#else
+	char name[256] = {};
+	if (gethostname(name, sizeof(name) - 1) == 0)
+		host = name;
+#endif
+
+#if defined(__AVX512F__)
+	const char *isa = "avx512";
+#elif defined(__AVX2__)
+	const char *isa = "avx2";
+#elif defined(__AVX__)
+	const char *isa = "avx";
+#elif defined(__SSE2__) || defined(_M_X64)
+	const char *isa = "sse2";
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+	const char *isa = "neon";
+#else
+	const char *isa = "generic";
+#endif
+
+	std::ostringstream key;
+	key << host << '/' << std::thread::hardware_concurrency() << '/' << isa
+		<< "/d" << config.polynomialDegree << "-p" << roundUpToPowerOfTwo(config.populationSize)
+		<< "-n" << roundUpToPowerOfTwo(positiveSet.getPointsetSize() + negativeSet.getPointsetSize())
+		<< '-' << (config.useBitmaskOperators ? config.geneCodec : "child") << (config.steadyState ? "-steady" : "");
+	return key.str();
+}
+
+// The executor breeds child by child, so pipelined candidates only search the same way as the sequential
+// loop when that does too; the precision never changes the search
+bool isChoiceSupported(const RunConfig &config, const TuneChoice &choice)
+{
+	return choice.pipelineThreads == 0 || !config.useBitmaskOperators;
+}
+
+// Every stride-th point of the set
+PointSet* samplePoints(const PointSet &set, int stride)
+{
+	PointSet *sample = new PointSet(set.isPositive());
+	for (int i = 0; i < set.getPointsetSize(); i += stride)
+		sample->addPoint(set.getPointAt(i));
+	return sample;
+}
+
+// Seconds of one generation of the sequential loop, bred by the packed operators when the run uses them
+// and child by child otherwise
+double timeSequentialGeneration(const RunConfig &config, GenerationOperators &operators, Population &population,
+	const PointSet &positiveSet, const PointSet &negativeSet, bool useMixedPrecision)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<ParentPair> pairs = chooseParentPairs(population, config.populationSize);
+	if (config.useBitmaskOperators)
+	{
+		std::vector<Curve*> *children = operators.breed(population, pairs, config.mutationRate);
+		for (unsigned int i = 0; i < children->size(); i++)
+		{
+			children->at(i)->setFitness(useMixedPrecision ? calculateMixedFitness(*children->at(i), positiveSet, negativeSet, nullptr) :
+				calculateFitness(*children->at(i), positiveSet, negativeSet));
+			delete children->at(i);
+		}
+		delete children;
+	}
+	else
+		for (unsigned int i = 0; i < pairs.size(); i++)
+		{
+			Curve *child = crossoverParents(*population.getCurveAt(pairs[i].first), *population.getCurveAt(pairs[i].second),
+				config.crossoverProportion);
+			if (getRandomNumber(0.0, 1.0) < config.mutationRate)
+				for (int j = 0; j < child->getDegree() + 1; j++)
+					child->getCoefficientAt(j)->mutateCoefficient();
+			child->setFitness(useMixedPrecision ? calculateMixedFitness(*child, positiveSet, negativeSet, nullptr) :
+				calculateFitness(*child, positiveSet, negativeSet));
+			delete child;
+		}
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Seconds of one generation bred and evaluated by the executor
+double timePipelinedGeneration(const RunConfig &config, PipelinedExecutor &executor, Population &population)
+{
+	SolveControl control;
+	std::vector<Curve*> children;
+	std::vector<ParentPair> pairs;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	executor.breedGeneration(population, config.populationSize, children, pairs, control);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	for (unsigned int i = 0; i < children.size(); i++)
+		delete children.at(i);
+	return seconds;
+}
+
+TuneChoice profileStrategies(const RunConfig &config, const PointSet &positiveSet, const PointSet &negativeSet)
+{
+	// Profiling draws random numbers, a seeded run has to start from the same state whether it ran or not
+	std::mt19937 randomState = saveRandomNumberGenerator();
+	int pointNum = positiveSet.getPointsetSize() + negativeSet.getPointsetSize();
+	int stride = std::max(1, (pointNum + maxProfilePoints - 1) / maxProfilePoints);
+	PointSet *ppos = samplePoints(positiveSet, stride);
+	PointSet *pneg = samplePoints(negativeSet, stride);
+
+	// Parents need a fitness for the roulette wheel
+	Population *population = new Population(config.populationSize, config.polynomialDegree, config.minCoefficient,
+		config.maxCoefficient);
+	for (int i = 0; i < population->getPopulationSize(); i++)
+		population->getCurveAt(i)->setFitness(calculateFitness(*population->getCurveAt(i), *ppos, *pneg));
+
+	GenerationOperators *operators = new GenerationOperators(config);
+
+	std::vector<int> threadCounts{ 0 };
+	int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	for (int threads = 1; threads <= hardwareThreads; threads *= 2)
+		threadCounts.push_back(threads);
+	if (threadCounts.back() != hardwareThreads)
+		threadCounts.push_back(hardwareThreads);
+
+	TuneChoice best{ false, 0, -1.0 };
+	for (int precision = 0; precision < 2; precision++)
+		for (unsigned int t = 0; t < threadCounts.size(); t++)
+		{
+			RunConfig candidate = config;
+			candidate.useMixedPrecision = precision == 1;
+			candidate.pipelineThreads = threadCounts.at(t);
+			if (!isChoiceSupported(config, TuneChoice{ candidate.useMixedPrecision, candidate.pipelineThreads, 0.0 }))
+				continue;
+			PipelinedExecutor *executor = candidate.pipelineThreads > 0 ? new PipelinedExecutor(candidate, *ppos, *pneg) : nullptr;
+
+			double seconds = -1.0;
+			for (int r = 0; r <= profileRepetitions; r++)
+			{
+				double generation = executor != nullptr ? timePipelinedGeneration(candidate, *executor, *population) :
+					timeSequentialGeneration(candidate, *operators, *population, *ppos, *pneg, candidate.useMixedPrecision);
+				if (r > 0 && (seconds < 0.0 || generation < seconds))
+					seconds = generation;
+			}
+			delete executor;
+
+			if (best.seconds < 0.0 || seconds < best.seconds)
+				best = TuneChoice{ candidate.useMixedPrecision, candidate.pipelineThreads, seconds };
+		}
+
+	delete population;
+	delete operators;
+	delete ppos;
+	delete pneg;
+	restoreRandomNumberGenerator(randomState);
+	return best;
+}
+
+// Profile lines are "key choice seconds", the last line for a key wins
+bool findCachedChoice(const std::string &filename, const std::string &key, TuneChoice &choice)
+{
+	std::ifstream inf(filename);
+	bool isFound = false;
+	std::string line;
+	while (std::getline(inf, line))
+	{
+		std::istringstream fields(line);
+		std::string lineKey, name;
+		double seconds;
+		TuneChoice parsed;
+		if (fields >> lineKey >> name >> seconds && lineKey == key && parseTuneChoice(name, parsed))
+		{
+			parsed.seconds = seconds;
+			choice = parsed;
+			isFound = true;
+		}
+	}
+	return isFound;
+}
+
+TuneChoice autotuneEvaluation(RunConfig &config, const PointSet &positiveSet, const PointSet &negativeSet, bool &isCached)
+{
+	TuneChoice choice{ false, 0, 0.0 };
+	isCached = false;
+	if (!config.forceStrategy.empty())
+	{
+		parseTuneChoice(config.forceStrategy, choice);
+		if (!isChoiceSupported(config, choice))
+		{
+			std::cerr << "The pipelined executor breeds child by child, children of the packed operators "
+				"are evaluated sequentially" << std::endl;
+			choice.pipelineThreads = 0;
+		}
+	}
+	else
+	{
+		std::string key = getTuneKey(config, positiveSet, negativeSet);
+		// A hand edited or outdated profile line is profiled again
+		isCached = findCachedChoice(config.autotuneProfile, key, choice) && isChoiceSupported(config, choice);
+		if (!isCached)
+		{
+			choice = profileStrategies(config, positiveSet, negativeSet);
+			std::ofstream outf(config.autotuneProfile, std::ios::app);
+			if (outf)
+				outf << key << ' ' << getTuneChoiceName(choice) << ' ' << choice.seconds << '\n';
+			else
+				std::cerr << "Cannot open " << config.autotuneProfile << " for writing" << std::endl;
+		}
+	}
+
+	config.useMixedPrecision = choice.useMixedPrecision;
+	config.pipelineThreads = choice.pipelineThreads;
+	return choice;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "stdafx.h"
+#include "PointSet.h"
+#include "RunConfig.h"
+#include <string>
+
+// Evaluation strategy of the generation loop: double or mixed precision fitness, sequential or pipelined
+// on a number of evaluation threads (0 is the sequential loop)
+struct TuneChoice
+{
+	bool useMixedPrecision;
+	int pipelineThreads;
+	double seconds;
+};
+
+// Reads "scalar" or "mixed", optionally followed by ":threads"
+bool parseTuneChoice(const std::string &text, TuneChoice &choice);
+
+std::string getTuneChoiceName(const TuneChoice &choice);
+
+// Key of the host (name, hardware threads, instruction set of the build), the bucketed problem shape
+// (degree, population size and point count rounded up to powers of two) and the breeding (gene codec of the
+// packed operators or child by child, steady state) in the profile file
+std::string getTuneKey(const RunConfig &config, const PointSet &positiveSet, const PointSet &negativeSet);
+
+// Whether the run may use the strategy: pipelined evaluation is not used with the packed operators
+bool isChoiceSupported(const RunConfig &config, const TuneChoice &choice);
+
+// Times one generation (breeding and evaluation) of every candidate on a sample of the point sets and a random
+// population of the configured size, and returns the fastest. Candidates are both precisions, sequential and,
+// unless the run breeds with the packed operators, pipelined with 1, 2, 4, ... threads up to the hardware threads.
+// The random generator of the calling thread is left as it was
+TuneChoice profileStrategies(const RunConfig &config, const PointSet &positiveSet, const PointSet &negativeSet);
+
+// Picks the strategy for the run: the forced one, the one cached in the profile for this key,
+// or a freshly profiled one which is then appended to the profile. Forced and cached choices the run
+// does not support are replaced. The choice is written into config
+TuneChoice autotuneEvaluation(RunConfig &config, const PointSet &positiveSet, const PointSet &negativeSet, bool &isCached);
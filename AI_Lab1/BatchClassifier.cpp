@@ -0,0 +1,239 @@
+#include "stdafx.h"
+#include "BatchClassifier.h"
+#include "Functions.h"
+#include "ThreadPool.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <string>
+
+// Classified part of a chunk
+struct ChunkPart
+{
+	std::vector<double> x;
+	std::vector<double> y;
+	std::vector<signed char> known;
+	std::vector<unsigned char> labels;
+	ConfusionCounts counts;
+};
+
+// Parses "x y [label]" lines of the range, empty lines and lines starting with # are skipped.
+// The chunk is not NUL-terminated, so every line is parsed from its own terminated copy
+void parseTextRange(const char *begin, const char *end, int knownLabel, ChunkPart &part)
+{
+	std::string text;
+	const char *line = begin;
+	while (line < end)
+	{
+		const char *lineEnd = static_cast<const char*>(memchr(line, '\n', end - line));
+		if (lineEnd == nullptr)
+			lineEnd = end;
+		text.assign(line, lineEnd);
+
+		const char *field = text.c_str();
+		char *next;
+		double x = strtod(field, &next);
+		if (next != field)
+		{
+			field = next;
+			double y = strtod(field, &next);
+			if (next != field)
+			{
+				field = next;
+				long label = strtol(field, &next, 10);
+				part.x.push_back(x);
+				part.y.push_back(y);
+				part.known.push_back(static_cast<signed char>(next != field ? (label != 0) : knownLabel));
+			}
+		}
+		line = lineEnd + 1;
+	}
+}
+
+// Unpacks interleaved binary x, y doubles
+void parseBinaryRange(const char *begin, const char *end, int knownLabel, ChunkPart &part)
+{
+	size_t pointNum = (end - begin) / (2 * sizeof(double));
+	part.x.resize(pointNum);
+	part.y.resize(pointNum);
+	part.known.assign(pointNum, static_cast<signed char>(knownLabel));
+	for (size_t i = 0; i < pointNum; i++)
+	{
+		memcpy(&part.x[i], begin + i * 2 * sizeof(double), sizeof(double));
+		memcpy(&part.y[i], begin + i * 2 * sizeof(double) + sizeof(double), sizeof(double));
+	}
+}
+
+void classifyPart(const std::vector<double> &coefficients, ChunkPart &part)
+{
+	int count = static_cast<int>(part.x.size());
+	part.labels.resize(count);
+	classifyBatch(coefficients, part.x.data(), part.y.data(), part.labels.data(), count);
+
+	part.counts = ConfusionCounts{ 0, 0, 0, 0, 0 };
+	for (int i = 0; i < count; i++)
+	{
+		int known = part.known[i];
+		int label = part.labels[i];
+		part.counts.truePositive += known == 1 && label == 1;
+		part.counts.falseNegative += known == 1 && label == 0;
+		part.counts.trueNegative += known == 0 && label == 0;
+		part.counts.falsePositive += known == 0 && label == 1;
+		part.counts.unlabeled += known < 0;
+	}
+}
+
+bool classifyPointFile(const std::vector<double> &coefficients, const std::string &inputFile, bool isBinary,
+	int knownLabel, const std::string &outputFile, int threads, int chunkBytes, ConfusionCounts &counts,
+	long long &pointNum)
+{
+	counts = ConfusionCounts{ 0, 0, 0, 0, 0 };
+	pointNum = 0;
+
+	FILE *input = fopen(inputFile.c_str(), "rb");
+	if (input == nullptr)
+	{
+		std::cerr << "Cannot open " << inputFile << " for reading" << std::endl;
+		return false;
+	}
+
+	FILE *output = nullptr;
+	if (!outputFile.empty())
+	{
+		output = fopen(outputFile.c_str(), "wb");
+		if (output == nullptr)
+		{
+			std::cerr << "Cannot open " << outputFile << " for writing" << std::endl;
+			fclose(input);
+			return false;
+		}
+	}
+
+	// Binary chunks hold whole records, text chunks are cut after the last complete line
+	const size_t recordSize = 2 * sizeof(double);
+	size_t chunkSize = std::max(static_cast<size_t>(chunkBytes), recordSize);
+	if (isBinary)
+		chunkSize -= chunkSize % recordSize;
+
+	ThreadPool pool(threads);
+	int partNum = pool.getThreadNum();
+	std::vector<ChunkPart> parts(partNum);
+	std::vector<char> buffer(chunkSize);
+	std::vector<char> outputBuffer;
+	size_t carry = 0;
+	bool isEnd = false;
+	bool isOk = true;
+
+	while (!isEnd)
+	{
+		size_t read = fread(buffer.data() + carry, 1, chunkSize - carry, input);
+		size_t length = carry + read;
+		isEnd = read == 0 || feof(input);
+
+		// Data after the last boundary is carried to the next chunk
+		size_t usable = length;
+		if (!isEnd)
+		{
+			if (isBinary)
+				usable = length - length % recordSize;
+			else
+			{
+				while (usable > 0 && buffer[usable - 1] != '\n')
+					usable--;
+				if (usable == 0)
+				{
+					std::cerr << "Line longer than the chunk in " << inputFile << std::endl;
+					isOk = false;
+					break;
+				}
+			}
+		}
+
+		// Split the chunk between threads at record or line boundaries
+		std::vector<size_t> bounds(partNum + 1, usable);
+		bounds[0] = 0;
+		for (int p = 1; p < partNum; p++)
+		{
+			size_t bound = std::max(bounds[p - 1], usable * p / partNum);
+			if (isBinary)
+				bound -= bound % recordSize;
+			else
+				while (bound < usable && bound > 0 && buffer[bound - 1] != '\n')
+					bound++;
+			bounds[p] = bound;
+		}
+
+		for (int p = 0; p < partNum; p++)
+		{
+			pool.submit([&, p]
+			{
+				ChunkPart &part = parts[p];
+				part.x.clear();
+				part.y.clear();
+				part.known.clear();
+				if (isBinary)
+					parseBinaryRange(buffer.data() + bounds[p], buffer.data() + bounds[p + 1], knownLabel, part);
+				else
+					parseTextRange(buffer.data() + bounds[p], buffer.data() + bounds[p + 1], knownLabel, part);
+				classifyPart(coefficients, part);
+			});
+		}
+		pool.wait();
+
+		// Gather results in file order and write them with one block write
+		outputBuffer.clear();
+		for (int p = 0; p < partNum; p++)
+		{
+			ChunkPart &part = parts[p];
+			counts.truePositive += part.counts.truePositive;
+			counts.falsePositive += part.counts.falsePositive;
+			counts.trueNegative += part.counts.trueNegative;
+			counts.falseNegative += part.counts.falseNegative;
+			counts.unlabeled += part.counts.unlabeled;
+			pointNum += part.labels.size();
+
+			if (output == nullptr)
+				continue;
+			for (unsigned int i = 0; i < part.labels.size(); i++)
+			{
+				if (isBinary)
+					outputBuffer.push_back(static_cast<char>(part.labels[i]));
+				else
+				{
+					outputBuffer.push_back(part.labels[i] ? '1' : '0');
+					outputBuffer.push_back('\n');
+				}
+			}
+		}
+		if (output != nullptr && !outputBuffer.empty() &&
+			fwrite(outputBuffer.data(), 1, outputBuffer.size(), output) != outputBuffer.size())
+		{
+			std::cerr << "Cannot write labels to " << outputFile << std::endl;
+			isOk = false;
+			break;
+		}
+
+		carry = length - usable;
+		memmove(buffer.data(), buffer.data() + usable, carry);
+	}
+
+	if (isOk && ferror(input))
+	{
+		std::cerr << "Cannot read " << inputFile << std::endl;
+		isOk = false;
+	}
+	fclose(input);
+	// Buffered labels are only known to be written once the file is flushed and closed
+	if (output != nullptr)
+	{
+		bool isWritten = !ferror(output);
+		isWritten = fclose(output) == 0 && isWritten;
+		if (!isWritten && isOk)
+		{
+			std::cerr << "Cannot write labels to " << outputFile << std::endl;
+			isOk = false;
+		}
+	}
+	return isOk;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "stdafx.h"
+#include <string>
+#include <vector>
+
+// Confusion counts of classified points against their known labels
+struct ConfusionCounts
+{
+	long long truePositive;
+	long long falsePositive;
+	long long trueNegative;
+	long long falseNegative;
+	long long unlabeled;
+};
+
+// Streams point file through the classifier in fixed-size chunks, so memory stays bounded by the chunk size.
+// Text files hold "x y [label]" lines as written by ExportData, binary files hold pairs of doubles.
+// knownLabel (0 or 1) applies to every point without own label, -1 means unknown.
+// Each chunk is split between threads at line boundaries; labels go to outputFile (if not empty) with one
+// block write per chunk, as "0"/"1" lines for text input and as bytes for binary input
+bool classifyPointFile(const std::vector<double> &coefficients, const std::string &inputFile, bool isBinary,
+	int knownLabel, const std::string &outputFile, int threads, int chunkBytes, ConfusionCounts &counts,
+	long long &pointNum);
@@ -0,0 +1,64 @@
+#include "stdafx.h"
+#include "BatchSolver.h"
+#include "RandomNumberGenerator.h"
+#include <algorithm>
+#include <chrono>
+
+double estimateProblemCost(const SolveProblem &problem)
+{
+	double pointNum = problem.positiveSet->getPointsetSize() + problem.negativeSet->getPointsetSize();
+	return pointNum * problem.config.populationSize * (problem.config.maxGeneration + 1.0);
+}
+
+SolveOutcome solveProblem(const SolveProblem &problem, const SolveControl *control)
+{
+	if (problem.config.seed != 0)
+		seedRandomNumberGenerator(problem.config.seed);
+
+	SolveOutcome outcome;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	outcome.result = GeneticAlgorithm(problem.config, *problem.positiveSet, *problem.negativeSet, control);
+	outcome.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	outcome.evaluations = outcome.result.evaluations;
+	return outcome;
+}
+
+BatchSolver::BatchSolver(int threads) : m_pool(threads)
+{
+
+}
+
+std::vector<SolveOutcome> BatchSolver::solveAll(std::vector<SolveProblem> &problems)
+{
+	std::vector<SolveOutcome> outcomes(problems.size());
+	m_control.reset();
+
+	std::vector<int> order;
+	for (unsigned int i = 0; i < problems.size(); i++)
+		order.push_back(i);
+	std::stable_sort(order.begin(), order.end(), [&problems](int a, int b)
+		{ return estimateProblemCost(problems.at(a)) > estimateProblemCost(problems.at(b)); });
+
+	// The pool takes tasks in submission order, so the largest problems start first
+	for (unsigned int i = 0; i < order.size(); i++)
+	{
+		int idx = order.at(i);
+		m_pool.submit([this, &problems, &outcomes, idx]
+		{
+			outcomes.at(idx) = solveProblem(problems.at(idx), &m_control);
+		});
+	}
+
+	m_pool.wait();
+	return outcomes;
+}
+
+void BatchSolver::cancel()
+{
+	m_control.cancel();
+}
+
+int BatchSolver::getThreadNum()
+{
+	return m_pool.getThreadNum();
+}
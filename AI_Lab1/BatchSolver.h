@@ -0,0 +1,49 @@
+#pragma once
+#include "stdafx.h"
+#include "GeneticAlgorithm.h"
+#include "PointSet.h"
+#include "RunConfig.h"
+#include "SolveControl.h"
+#include "ThreadPool.h"
+#include <vector>
+
+// One separation problem: point sets and run parameters. Point sets may be shared between problems
+// as long as the cutoff mode does not reorder them (hardestPointsFirst)
+struct SolveProblem
+{
+	RunConfig config;
+	PointSet *positiveSet;
+	PointSet *negativeSet;
+};
+
+// Result of one problem together with its run statistics
+struct SolveOutcome
+{
+	RunResult result;
+	double seconds;
+	long long evaluations;
+};
+
+// Estimated work of the problem: points x individuals x generations
+double estimateProblemCost(const SolveProblem &problem);
+
+// Solves one problem on the calling thread. Reentrant: the problem only touches its own point sets and
+// population, the random generator of the calling thread is reseeded when the config has a seed.
+// The run stops at config.timeBudget or when the optional control is cancelled
+SolveOutcome solveProblem(const SolveProblem &problem, const SolveControl *control = nullptr);
+
+// Solves many problems concurrently on one shared thread pool, largest problems are started first
+// so that a big problem does not end up alone at the end of the batch. Outcomes keep the order of problems.
+// cancel may be called from another thread, running problems then return their best curve so far.
+// A cancel only stops the batch in progress, the next solveAll starts uncancelled
+class BatchSolver
+{
+	ThreadPool m_pool;
+	SolveControl m_control;
+
+public:
+	BatchSolver(int threads);
+	std::vector<SolveOutcome> solveAll(std::vector<SolveProblem> &problems);
+	void cancel();
+	int getThreadNum();
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include "stdafx.h"
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+
+// Lock-free ring buffer between exactly one producer thread and one consumer thread.
+// The capacity is rounded up to a power of two; tryPush fails when the queue is full and tryPop when it is empty,
+// so neither side ever blocks. The indices only grow, the producer owns m_tail and the consumer owns m_head
+template <typename T>
+class BoundedQueue
+{
+	std::vector<T> m_slots;
+	size_t m_mask;
+	alignas(64) std::atomic<size_t> m_head;
+	alignas(64) std::atomic<size_t> m_tail;
+
+public:
+	BoundedQueue(size_t capacity) : m_head(0), m_tail(0)
+	{
+		size_t size = 1;
+		while (size < capacity)
+			size <<= 1;
+		m_slots.resize(size);
+		m_mask = size - 1;
+	}
+
+	bool tryPush(const T &value)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+			return false;
+		m_slots[tail & m_mask] = value;
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool tryPop(T &value)
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+		if (head == m_tail.load(std::memory_order_acquire))
+			return false;
+		value = m_slots[head & m_mask];
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+};
@@ -0,0 +1,120 @@
+#include "stdafx.h"
+#include "ClassificationBits.h"
+#include "Functions.h"
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+int popcount64(uint64_t word)
+{
+#ifdef _MSC_VER
+	return static_cast<int>(__popcnt64(word));
+#else
+	return __builtin_popcountll(word);
+#endif
+}
+
+// Classifies all points by the curve function, bits are ORed in without branches
+ClassificationBits::ClassificationBits(const Curve &curve, const PointSet &positiveSet, const PointSet &negativeSet)
+{
+	int positivesetSize = positiveSet.getPointsetSize();
+	int negativesetSize = negativeSet.getPointsetSize();
+	m_pointNum = positivesetSize + negativesetSize;
+	m_words.assign((m_pointNum + 63) / 64, 0);
+
+	bool(*fcnPtr)(double x, double y, const Curve &curve) = getCurveFunction(curve.getDegree());
+	if (fcnPtr == nullptr)
+		return;
+
+	for (int i = 0; i < positivesetSize; i++)
+	{
+		const Point &point = positiveSet.getPointAt(i);
+		m_words[i >> 6] |= static_cast<uint64_t>(fcnPtr(point.getX(), point.getY(), curve)) << (i & 63);
+	}
+
+	for (int i = 0; i < negativesetSize; i++)
+	{
+		const Point &point = negativeSet.getPointAt(i);
+		int idx = positivesetSize + i;
+		m_words[idx >> 6] |= static_cast<uint64_t>(!fcnPtr(point.getX(), point.getY(), curve)) << (idx & 63);
+	}
+}
+
+int ClassificationBits::getPointNum()
+{
+	return m_pointNum;
+}
+
+int ClassificationBits::countCorrect()
+{
+	int correct = 0;
+	for (unsigned int i = 0; i < m_words.size(); i++)
+		correct += popcount64(m_words[i]);
+	return correct;
+}
+
+double ClassificationBits::getFitness()
+{
+	return m_pointNum == 0 ? 0.0 : (double)countCorrect() / m_pointNum;
+}
+
+// Number of points classified differently by two curves
+int ClassificationBits::distanceTo(ClassificationBits &other)
+{
+	int distance = 0;
+	for (unsigned int i = 0; i < m_words.size(); i++)
+		distance += popcount64(m_words[i] ^ other.m_words.at(i));
+	return distance;
+}
+
+std::vector<uint64_t>& ClassificationBits::getWords()
+{
+	return m_words;
+}
+
+ClassificationBits::~ClassificationBits()
+{
+
+}
+
+std::vector<int> calculatePointDifficulty(std::vector<ClassificationBits*> &results)
+{
+	if (results.empty())
+		return std::vector<int>();
+
+	int pointNum = results.at(0)->getPointNum();
+	std::vector<int> difficulty(pointNum, static_cast<int>(results.size()));
+
+	for (unsigned int r = 0; r < results.size(); r++)
+	{
+		std::vector<uint64_t> &words = results.at(r)->getWords();
+		for (unsigned int w = 0; w < words.size(); w++)
+		{
+			uint64_t word = words[w];
+			if (word == 0)
+				continue;
+			int bitNum = std::min(64, pointNum - static_cast<int>(w) * 64);
+			for (int bit = 0; bit < bitNum; bit++)
+				difficulty[w * 64 + bit] -= static_cast<int>((word >> bit) & 1);
+		}
+	}
+	return difficulty;
+}
+
+double calculateBehaviouralDiversity(std::vector<ClassificationBits*> &results)
+{
+	if (results.size() < 2 || results.at(0)->getPointNum() == 0)
+		return 0.0;
+
+	long long distanceSum = 0;
+	long long pairNum = 0;
+	for (unsigned int i = 0; i < results.size(); i++)
+		for (unsigned int j = i + 1; j < results.size(); j++)
+		{
+			distanceSum += results.at(i)->distanceTo(*results.at(j));
+			pairNum++;
+		}
+
+	return (double)distanceSum / pairNum / results.at(0)->getPointNum();
+}
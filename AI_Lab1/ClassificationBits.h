@@ -0,0 +1,33 @@
+#pragma once
+#include "stdafx.h"
+#include "Curve.h"
+#include "PointSet.h"
+#include <cstdint>
+#include <vector>
+
+// Counts set bits of 64-bit word
+int popcount64(uint64_t word);
+
+// Packed per-point correctness of one curve, positive points go first then negative ones.
+// Bit is set when the curve classifies the point correctly, so fitness is a popcount. The bits come from the
+// same curve functions as calculateFitness, one point at a time; the packing pays off in the popcount analytics
+class ClassificationBits
+{
+	std::vector<uint64_t> m_words;
+	int m_pointNum;
+
+public:
+	ClassificationBits(const Curve &curve, const PointSet &positiveSet, const PointSet &negativeSet);
+	int getPointNum();
+	int countCorrect();
+	double getFitness();
+	int distanceTo(ClassificationBits &other);
+	std::vector<uint64_t>& getWords();
+	~ClassificationBits();
+};
+
+// Number of individuals which misclassify every point (per-point difficulty)
+std::vector<int> calculatePointDifficulty(std::vector<ClassificationBits*> &results);
+
+// Average pairwise Hamming distance between classification results, normalized to the number of points
+double calculateBehaviouralDiversity(std::vector<ClassificationBits*> &results);
@@ -117,7 +117,7 @@ void invertBit(int &bit)
 	else bit = 1;
 }
 
-void Coefficient::printBinary()
+void Coefficient::printBinary() const
 {
 	std::string temp ="";
 	for (unsigned int i = 0; i < m_binaryRep.size(); i++)
@@ -131,12 +131,12 @@ void Coefficient::setNumber(int number)
 	m_binaryRep = decimalToBinary(m_number);
 }
 
-int Coefficient::getNumber()
+int Coefficient::getNumber() const
 {
 	return m_number;
 }
 
-std::deque<int> Coefficient::getBinaryRep()
+const std::deque<int>& Coefficient::getBinaryRep() const
 {
 	return m_binaryRep;
 }
@@ -157,7 +157,7 @@ void Coefficient::mutateCoefficient()
 	// Mutation is possible on every bit except the last one (to exclude mutation to zero)
 	for (unsigned int i = 0; i < m_binaryRep.size()-1; i++)
 
-		if (getRandomNumber(0.0, 1.0) < 0.5)
+		if (getRandomNumber(0.0, 1.0) < bitMutationProbability)
 		{
 			//std::cout << "mutate bit #" << i << '\n';
 			invertBit(m_binaryRep.at(i));
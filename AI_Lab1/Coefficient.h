@@ -7,6 +7,10 @@ int binaryToDecimal(std::deque<int> bits);
 std::deque<int> decimalToBinary(int number);
 
 
+// Probability of flipping each bit of a mutated gene, except the last one. The packed operators
+// and the compiled engine mutate with the same probability
+const double bitMutationProbability = 0.25;
+
 // Gene (one element position in chromosome)
 class Coefficient
 {
@@ -20,9 +24,9 @@ public:
 	void setNumber(int number);
 	void mutateCoefficient(std::array<int, 8> mutationBits);
 	void mutateCoefficient();
-	int getNumber();
-	std::deque<int> getBinaryRep();
+	int getNumber() const;
+	const std::deque<int>& getBinaryRep() const;
 	~Coefficient();
-	void printBinary();
+	void printBinary() const;
 };
 
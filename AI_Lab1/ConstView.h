@@ -0,0 +1,29 @@
+#pragma once
+#include "stdafx.h"
+#include <cstddef>
+#include <vector>
+
+
+// Read-only view of contiguous elements owned by someone else (std::span<const T> for C++17).
+// The view does not copy anything and stays valid while the owner is not resized or destroyed
+template <typename T>
+class ConstView
+{
+	const T *m_data;
+	size_t m_size;
+
+public:
+	ConstView() : m_data(nullptr), m_size(0) {}
+	ConstView(const T *data, size_t size) : m_data(data), m_size(size) {}
+	ConstView(const std::vector<T> &elements) : m_data(elements.data()), m_size(elements.size()) {}
+
+	const T* data() const { return m_data; }
+	size_t size() const { return m_size; }
+	bool empty() const { return m_size == 0; }
+	const T& operator[](size_t idx) const { return m_data[idx]; }
+	const T* begin() const { return m_data; }
+	const T* end() const { return m_data + m_size; }
+
+	// Elements [offset, offset + count) of this view
+	ConstView<T> subview(size_t offset, size_t count) const { return ConstView<T>(m_data + offset, count); }
+};
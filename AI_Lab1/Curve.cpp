@@ -7,6 +7,8 @@
 Curve::Curve(int degree, int minCoefficient, int maxCoefficient) : m_degree(degree)
 {
 	m_fitness = 0;
+	m_isFitnessExact = true;
+	m_positiveHits = m_negativeHits = m_testedPositive = m_testedNegative = 0;
 	m_coefficients = new std::vector<Coefficient*>();
 
 	// First coefficient shild be other than zero
@@ -22,15 +24,17 @@ Curve::Curve(std::vector<Coefficient*> *coefficients)
 {
 	m_degree = coefficients->size() - 1;
 	m_fitness = 0;
+	m_isFitnessExact = true;
+	m_positiveHits = m_negativeHits = m_testedPositive = m_testedNegative = 0;
 	m_coefficients = coefficients;
 }
 
-int Curve::getDegree()
+int Curve::getDegree() const
 {
 	return m_degree;
 }
 
-double Curve::getFitness()
+double Curve::getFitness() const
 {
 	return m_fitness;
 }
@@ -38,6 +42,52 @@ double Curve::getFitness()
 void Curve::setFitness(double fitness)
 {
 	m_fitness = fitness;
+	m_isFitnessExact = true;
+}
+
+// Fitness measured on a sample of the points, good for selection but not for reporting the best curve
+void Curve::setEstimatedFitness(double fitness)
+{
+	m_fitness = fitness;
+	m_isFitnessExact = false;
+}
+
+bool Curve::isFitnessExact() const
+{
+	return m_isFitnessExact;
+}
+
+// Accumulates classification results of newly tested points
+void Curve::addHits(int positiveHits, int positiveTested, int negativeHits, int negativeTested)
+{
+	m_positiveHits += positiveHits;
+	m_testedPositive += positiveTested;
+	m_negativeHits += negativeHits;
+	m_testedNegative += negativeTested;
+}
+
+// Takes over the classification results of a curve with the same coefficients
+void Curve::copyHits(const Curve &curve)
+{
+	m_positiveHits = curve.m_positiveHits;
+	m_negativeHits = curve.m_negativeHits;
+	m_testedPositive = curve.m_testedPositive;
+	m_testedNegative = curve.m_testedNegative;
+}
+
+int Curve::getHitCount() const
+{
+	return m_positiveHits + m_negativeHits;
+}
+
+int Curve::getTestedPositive() const
+{
+	return m_testedPositive;
+}
+
+int Curve::getTestedNegative() const
+{
+	return m_testedNegative;
 }
 
 Coefficient* Curve::getCoefficientAt(unsigned int idx)
@@ -45,9 +95,21 @@ Coefficient* Curve::getCoefficientAt(unsigned int idx)
 	return m_coefficients->at(idx);
 }
 
-std::vector<int> Curve::getDecimalCoefficients()
+const Coefficient* Curve::getCoefficientAt(unsigned int idx) const
+{
+	return m_coefficients->at(idx);
+}
+
+// Coefficients of a const curve can not be mutated through the view
+ConstView<const Coefficient*> Curve::getCoefficients() const
+{
+	return ConstView<const Coefficient*>(m_coefficients->data(), m_coefficients->size());
+}
+
+std::vector<int> Curve::getDecimalCoefficients() const
 {
 	std::vector<int> decimalCoef;
+	decimalCoef.reserve(m_coefficients->size());
 
 	for (unsigned int i = 0; i < m_coefficients->size(); i++)
 	{
@@ -56,7 +118,15 @@ std::vector<int> Curve::getDecimalCoefficients()
 	return decimalCoef;
 }
 
-void Curve::printCoefficients()
+// Writes coefficients into the caller's vector, so a reused vector is not reallocated
+void Curve::getDecimalCoefficients(std::vector<int> &coefficients) const
+{
+	coefficients.resize(m_coefficients->size());
+	for (unsigned int i = 0; i < m_coefficients->size(); i++)
+		coefficients[i] = (*m_coefficients)[i]->getNumber();
+}
+
+void Curve::printCoefficients() const
 {
 	for (unsigned int i = 0; i < m_coefficients->size(); i++)
 	{
@@ -65,8 +135,11 @@ void Curve::printCoefficients()
 	}
 }
 
+// The curve owns its coefficients
 Curve::~Curve()
 {
+	for (unsigned int i = 0; i < m_coefficients->size(); i++)
+		delete m_coefficients->at(i);
 	delete m_coefficients;
 	m_coefficients = nullptr;
 }
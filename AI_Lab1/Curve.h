@@ -1,6 +1,7 @@
 #pragma once
 #include "stdafx.h"
 #include "Coefficient.h"
+#include "ConstView.h"
 #include <vector>
 
 
@@ -10,16 +11,31 @@ class Curve
 	std::vector<Coefficient*> *m_coefficients;
 	int m_degree;
 	double m_fitness;
+	bool m_isFitnessExact;
+	int m_positiveHits;
+	int m_negativeHits;
+	int m_testedPositive;
+	int m_testedNegative;
 
 public:
 	Curve(int degree, int minCoefficient, int maxCoefficient);
 	Curve(std::vector<Coefficient*> *coefficients);
-	int getDegree();
+	int getDegree() const;
 	Coefficient* getCoefficientAt(unsigned int idx);
-	std::vector<int> getDecimalCoefficients();
-	double getFitness();
+	const Coefficient* getCoefficientAt(unsigned int idx) const;
+	ConstView<const Coefficient*> getCoefficients() const;
+	std::vector<int> getDecimalCoefficients() const;
+	void getDecimalCoefficients(std::vector<int> &coefficients) const;
+	double getFitness() const;
 	void setFitness(double fitness);
-	void printCoefficients();
+	void setEstimatedFitness(double fitness);
+	bool isFitnessExact() const;
+	void addHits(int positiveHits, int positiveTested, int negativeHits, int negativeTested);
+	void copyHits(const Curve &curve);
+	int getHitCount() const;
+	int getTestedPositive() const;
+	int getTestedNegative() const;
+	void printCoefficients() const;
 	~Curve();
 };
 
@@ -0,0 +1,321 @@
+#include "stdafx.h"
+#include "CurveServer.h"
+#include "Functions.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <cerrno>
+#include <cstring>
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+LatencyCounters::LatencyCounters() : m_count(0)
+{
+	for (int i = 0; i < bucketNum; i++)
+		m_buckets[i] = 0;
+}
+
+// Four buckets per power of two, starting from one microsecond
+void LatencyCounters::record(double microseconds)
+{
+	int bucket = microseconds <= 1.0 ? 0 : static_cast<int>(log2(microseconds) * 4);
+	if (bucket >= bucketNum)
+		bucket = bucketNum - 1;
+	m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	m_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Upper bound of the bucket containing the percentile
+double LatencyCounters::getPercentile(double percentile)
+{
+	long long count = m_count.load(std::memory_order_relaxed);
+	if (count == 0)
+		return 0.0;
+
+	long long rank = static_cast<long long>(ceil(percentile * count));
+	long long seen = 0;
+	for (int i = 0; i < bucketNum; i++)
+	{
+		seen += m_buckets[i].load(std::memory_order_relaxed);
+		if (seen >= rank)
+			return pow(2.0, (i + 1) / 4.0);
+	}
+	return pow(2.0, bucketNum / 4.0);
+}
+
+long long LatencyCounters::getCount()
+{
+	return m_count.load(std::memory_order_relaxed);
+}
+
+CurveServer::CurveServer(const std::string &socketPath, const std::string &checkpoint)
+	: m_socketPath(socketPath), m_checkpoint(checkpoint), m_isStopping(false), m_checkpointTime(0)
+{
+	std::shared_ptr<const std::vector<double>> empty = std::make_shared<const std::vector<double>>();
+	std::atomic_store(&m_coefficients, empty);
+	reloadIfChanged();
+}
+
+// Publishes new curve, requests being classified keep the old one until their batch is done
+void CurveServer::swapCurve(const std::vector<double> &coefficients)
+{
+	std::shared_ptr<const std::vector<double>> curve = std::make_shared<const std::vector<double>>(coefficients);
+	std::atomic_store(&m_coefficients, curve);
+}
+
+std::vector<double> CurveServer::getCurve()
+{
+	return *std::atomic_load(&m_coefficients);
+}
+
+void CurveServer::reloadIfChanged()
+{
+#ifdef __linux__
+	if (m_checkpoint.empty())
+		return;
+
+	struct stat info;
+	if (stat(m_checkpoint.c_str(), &info) != 0)
+		return;
+	long long modified = static_cast<long long>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+	if (modified == m_checkpointTime)
+		return;
+
+	std::vector<double> coefficients;
+	if (loadCurveCheckpoint(m_checkpoint, coefficients))
+	{
+		swapCurve(coefficients);
+		m_checkpointTime = modified;
+		std::cout << "Serving curve from " << m_checkpoint << std::endl;
+	}
+#endif
+}
+
+// A request line longer than this is never a point, the client is dropped
+const size_t maxRequestLength = 4096;
+
+// Parses "x y" with nothing but whitespace after it, the line ends with '\0'
+bool parseRequest(const char *line, double &x, double &y)
+{
+	char *end;
+	x = strtod(line, &end);
+	if (end == line)
+		return false;
+	const char *yStart = end;
+	y = strtod(yStart, &end);
+	if (end == yStart)
+		return false;
+	while (*end == ' ' || *end == '\t' || *end == '\r')
+		end++;
+	return *end == '\0' && std::isfinite(x) && std::isfinite(y);
+}
+
+// Classifies the collected points and appends their answers, a point that could not be parsed gets "ERR"
+void appendAnswers(const std::vector<double> &coefficients, std::vector<double> &x, std::vector<double> &y,
+	std::vector<unsigned char> &isValid, std::string &response)
+{
+	std::vector<unsigned char> labels(x.size());
+	if (!coefficients.empty())
+		classifyBatch(coefficients, x.data(), y.data(), labels.data(), static_cast<int>(x.size()));
+	for (unsigned int i = 0; i < labels.size(); i++)
+	{
+		if (!isValid[i])
+			response += "ERR bad request\n";
+		else
+			response += coefficients.empty() ? "ERR no curve\n" : (labels[i] ? "1\n" : "0\n");
+	}
+	x.clear();
+	y.clear();
+	isValid.clear();
+}
+
+// Classifies every complete line of the buffer and returns the answers, incomplete tail stays in buffer
+std::string CurveServer::handleRequests(std::string &buffer)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::shared_ptr<const std::vector<double>> coefficients = std::atomic_load(&m_coefficients);
+
+	std::string response;
+	std::vector<double> x, y;
+	std::vector<unsigned char> isValid;
+	int requestNum = 0;
+
+	size_t lineStart = 0;
+	size_t lineEnd;
+	while ((lineEnd = buffer.find('\n', lineStart)) != std::string::npos)
+	{
+		// strtod must not run into the next line
+		buffer[lineEnd] = '\0';
+		const char *line = buffer.c_str() + lineStart;
+		if (buffer.compare(lineStart, 5, "STATS") == 0)
+		{
+			// Answers of the points before the command go first
+			requestNum += static_cast<int>(x.size());
+			appendAnswers(*coefficients, x, y, isValid, response);
+
+			response += "requests=" + std::to_string(m_latency.getCount()) +
+				" p50_us=" + std::to_string(m_latency.getPercentile(0.50)) +
+				" p99_us=" + std::to_string(m_latency.getPercentile(0.99)) + "\n";
+		}
+		else
+		{
+			double px = 0.0, py = 0.0;
+			isValid.push_back(parseRequest(line, px, py));
+			x.push_back(isValid.back() ? px : 0.0);
+			y.push_back(isValid.back() ? py : 0.0);
+		}
+		lineStart = lineEnd + 1;
+	}
+	buffer.erase(0, lineStart);
+
+	requestNum += static_cast<int>(x.size());
+	appendAnswers(*coefficients, x, y, isValid, response);
+
+	// Every request of the batch waited for the whole batch
+	double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	for (int i = 0; i < requestNum; i++)
+		m_latency.record(microseconds);
+
+	return response;
+}
+
+// Serves until stop() is called, returns false if the socket can not be set up
+bool CurveServer::run()
+{
+#ifdef __linux__
+	int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	if (listenFd < 0)
+	{
+		std::cerr << "Cannot create socket" << std::endl;
+		return false;
+	}
+
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, m_socketPath.c_str(), sizeof(address.sun_path) - 1);
+	unlink(m_socketPath.c_str());
+	if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd, 128) != 0)
+	{
+		std::cerr << "Cannot listen on " << m_socketPath << std::endl;
+		close(listenFd);
+		return false;
+	}
+
+	int epollFd = epoll_create1(0);
+	epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.fd = listenFd;
+	epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+
+	// Pending input and output of every connection, and the connections the client has stopped writing to
+	std::map<int, std::string> input, output;
+	std::set<int> finished;
+	epoll_event events[64];
+	char chunk[65536];
+
+	std::cout << "Serving on " << m_socketPath << std::endl;
+	while (!m_isStopping)
+	{
+		int eventNum = epoll_wait(epollFd, events, 64, 500);
+		reloadIfChanged();
+
+		for (int e = 0; e < eventNum; e++)
+		{
+			int fd = events[e].data.fd;
+			if (fd == listenFd)
+			{
+				int client;
+				while ((client = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK)) >= 0)
+				{
+					epoll_event clientEvent = {};
+					clientEvent.events = EPOLLIN;
+					clientEvent.data.fd = client;
+					epoll_ctl(epollFd, EPOLL_CTL_ADD, client, &clientEvent);
+				}
+				continue;
+			}
+
+			// A client that half-closes after its requests still gets the answers, the connection
+			// is closed once they are written. Errors close it at once
+			bool isBroken = (events[e].events & EPOLLERR) != 0;
+			if ((events[e].events & (EPOLLIN | EPOLLHUP)) && !finished.count(fd))
+			{
+				// Lines are answered chunk by chunk, so a client that never ends its line is caught
+				// before its input grows past one chunk and the longest request
+				ssize_t received;
+				while ((received = read(fd, chunk, sizeof(chunk))) > 0)
+				{
+					input[fd].append(chunk, received);
+					output[fd] += handleRequests(input[fd]);
+					if (input[fd].size() > maxRequestLength)
+						break;
+				}
+				if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+					finished.insert(fd);
+				if (input[fd].size() > maxRequestLength)
+				{
+					// The answers so far are still written, the rest of the input is dropped
+					std::cerr << "Dropping client with a request line longer than " << maxRequestLength << " bytes" << std::endl;
+					input[fd].clear();
+					finished.insert(fd);
+				}
+			}
+
+			// Write as much as the socket takes, wait for EPOLLOUT for the rest
+			std::string &pending = output[fd];
+			while (!pending.empty() && !isBroken)
+			{
+				ssize_t sent = send(fd, pending.data(), pending.size(), MSG_NOSIGNAL);
+				if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+					isBroken = true;
+				if (sent <= 0)
+					break;
+				pending.erase(0, sent);
+			}
+
+			if (isBroken || (finished.count(fd) && pending.empty()))
+			{
+				epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+				close(fd);
+				input.erase(fd);
+				output.erase(fd);
+				finished.erase(fd);
+				continue;
+			}
+
+			epoll_event clientEvent = {};
+			clientEvent.events = finished.count(fd) ? EPOLLOUT : (pending.empty() ? EPOLLIN : (EPOLLIN | EPOLLOUT));
+			clientEvent.data.fd = fd;
+			epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &clientEvent);
+		}
+	}
+
+	for (std::map<int, std::string>::iterator it = input.begin(); it != input.end(); ++it)
+		close(it->first);
+	close(epollFd);
+	close(listenFd);
+	unlink(m_socketPath.c_str());
+	return true;
+#else
+	std::cerr << "Classification server requires Linux (epoll and Unix domain sockets)" << std::endl;
+	return false;
+#endif
+}
+
+void CurveServer::stop()
+{
+	m_isStopping = true;
+}
+
+LatencyCounters& CurveServer::getLatency()
+{
+	return m_latency;
+}
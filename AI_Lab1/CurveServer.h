@@ -0,0 +1,47 @@
+#pragma once
+#include "stdafx.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Latency histogram with logarithmic microsecond buckets, updated without locks
+class LatencyCounters
+{
+	static const int bucketNum = 64;
+	std::atomic<long long> m_buckets[bucketNum];
+	std::atomic<long long> m_count;
+
+public:
+	LatencyCounters();
+	void record(double microseconds);
+	double getPercentile(double percentile);
+	long long getCount();
+};
+
+// Answers "which side of the curve is (x, y)" over a Unix domain socket.
+// Requests are "x y" lines, answers are "1" (positive side, y above the curve) or "0" lines.
+// All complete lines of one read are classified as one batch, a malformed line is answered "ERR bad request"
+// and a client whose line grows past the longest request is dropped. A "STATS" line returns
+// request count and p50/p99 latency in microseconds. The curve can be swapped at any time without
+// dropping connections, the checkpoint file is reloaded when it changes
+class CurveServer
+{
+	std::string m_socketPath;
+	std::string m_checkpoint;
+	std::shared_ptr<const std::vector<double>> m_coefficients;
+	std::atomic<bool> m_isStopping;
+	LatencyCounters m_latency;
+	long long m_checkpointTime;
+
+	void reloadIfChanged();
+	std::string handleRequests(std::string &buffer);
+
+public:
+	CurveServer(const std::string &socketPath, const std::string &checkpoint);
+	void swapCurve(const std::vector<double> &coefficients);
+	std::vector<double> getCurve();
+	bool run();
+	void stop();
+	LatencyCounters& getLatency();
+};
@@ -2,57 +2,65 @@
 #include "stdafx.h"
 #include "Functions.h"
 #include "RandomNumberGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 
-bool isPointPositiveFirstDegree(double x, double y, Curve &curve);
-bool isPointPositiveSecondDegree(double x, double y, Curve &curve);
-bool isPointPositiveThirdDegree(double x, double y, Curve &curve);
-bool isPointPositiveFourthDegree(double x, double y, Curve &curve);
-bool isPointPositiveFifthDegree(double x, double y, Curve &curve);
+bool isPointPositiveFirstDegree(double x, double y, const Curve &curve);
+bool isPointPositiveSecondDegree(double x, double y, const Curve &curve);
+bool isPointPositiveThirdDegree(double x, double y, const Curve &curve);
+bool isPointPositiveFourthDegree(double x, double y, const Curve &curve);
+bool isPointPositiveFifthDegree(double x, double y, const Curve &curve);
 
-double calculateFitness(Curve &curve, PointSet &positiveSet, PointSet &negativeSet)
+// Selects curve function based on degree of polynomial, nullptr if the degree is not supported
+bool(*getCurveFunction(int curveDegree))(double x, double y, const Curve &curve)
 {
-	int fitnessScore = 0;
-
-	// function pointer for selecting curve function based on degree of polynomial
-	bool(*fcnPtr)(double x, double y, Curve &curve) = nullptr;
-
-	int curveDegree = curve.getDegree();
-
-	// calculate fitness basing on the degree of polynomial
 	switch (curveDegree)
 	{
 		case 1:
-			fcnPtr = isPointPositiveFirstDegree;
-			break;
+			return isPointPositiveFirstDegree;
 		case 2:
-			fcnPtr = isPointPositiveSecondDegree;
-			break;
+			return isPointPositiveSecondDegree;
 		case 3:
-			fcnPtr = isPointPositiveThirdDegree;
-			break;
+			return isPointPositiveThirdDegree;
 		case 4:
-			fcnPtr = isPointPositiveFourthDegree;
-			break;
+			return isPointPositiveFourthDegree;
 		case 5:
-			fcnPtr = isPointPositiveFifthDegree;
-			break;
+			return isPointPositiveFifthDegree;
 		default:
-			std::cout << "Fitness calculation is impossible for given degree\n";
-			return 0.0;	
+			return nullptr;
 	}
+}
 
-	int positivesetSize = positiveSet.getPointsetSize();
-	int negativesetSize = negativeSet.getPointsetSize();
+double calculateFitness(const Curve &curve, const PointSet &positiveSet, const PointSet &negativeSet)
+{
+	int fitnessScore = 0;
 
-	// Iterate throught the positive set
-	for (int i = 0; i < positivesetSize; i++)
-		if (fcnPtr(positiveSet.getPointAt(i).getX(), positiveSet.getPointAt(i).getY(), curve))
-			fitnessScore++;
+	// function pointer for selecting curve function based on degree of polynomial
+	bool(*fcnPtr)(double x, double y, const Curve &curve) = getCurveFunction(curve.getDegree());
+
+	if (fcnPtr == nullptr)
+	{
+		std::cout << "Fitness calculation is impossible for given degree\n";
+		return 0.0;
+	}
+
+	ConstView<Point> positives = positiveSet.getPoints();
+	ConstView<Point> negatives = negativeSet.getPoints();
+	ConstView<int> positiveWeights = positiveSet.getWeights();
+	ConstView<int> negativeWeights = negativeSet.getWeights();
+	int positivesetSize = positiveSet.getTotalWeight();
+	int negativesetSize = negativeSet.getTotalWeight();
+
+	// Iterate throught the positive set, a compacted point counts as many points as it merged
+	for (unsigned int i = 0; i < positives.size(); i++)
+		if (fcnPtr(positives[i].getX(), positives[i].getY(), curve))
+			fitnessScore += positiveWeights[i];
 
 	// Iterate throught the negative set
-	for (int i = 0; i < negativesetSize; i++)
-		if (!(fcnPtr(negativeSet.getPointAt(i).getX(), negativeSet.getPointAt(i).getY(), curve)))
-			fitnessScore++;
+	for (unsigned int i = 0; i < negatives.size(); i++)
+		if (!(fcnPtr(negatives[i].getX(), negatives[i].getY(), curve)))
+			fitnessScore += negativeWeights[i];
 
 	//std::cout << "fitness score = " << fitnessScore << ", number of points = " 
 		//<< positivesetSize + negativesetSize << std::endl;
@@ -63,38 +71,420 @@ double calculateFitness(Curve &curve, PointSet &positiveSet, PointSet &negativeS
 	return finalFitness;
 }
 
-bool isPointPositiveFirstDegree(double x, double y, Curve &curve)
+// Points classified in one float32 pass before the undecided ones are tested in double
+const int mixedBlockSize = 256;
+
+// Counts points of the set on their correct side. Horner's rule in float32 gives the residual r = y - p(x) and,
+// with absolute coefficients and |x|, the sum s = |y| + sum |c_k| |x|^k. Rounding x and y to float32 and
+// evaluating in float32 changes r by at most (3n + 3) u s for degree n and u = 2^-24; the bound used is
+// (4n + 8) u s, which also covers the rounding of s itself, plus an absolute term for coordinates that
+// underflow in float32. Only points with |r| within the bound go to the double test, so the sign always
+// agrees with it. The points sent to the double test are added to retested
+template <int CoefNum>
+int countMixedCorrect(const float *coefficients, const float *absCoefficients, const PointSet &set,
+	bool(*fcnPtr)(double x, double y, const Curve &curve), const Curve &curve, int &retested)
+{
+	const float boundFactor = (4 * CoefNum + 4) * 0x1p-24f;
+	const float boundMinimum = 1e-30f;
+
+	ConstView<float> xs = set.getFloatX();
+	ConstView<float> ys = set.getFloatY();
+	ConstView<int> weights = set.getWeights();
+	int pointNum = static_cast<int>(xs.size());
+	unsigned char sides[mixedBlockSize];
+	int score = 0;
+
+	for (int block = 0; block < pointNum; block += mixedBlockSize)
+	{
+		int blockSize = std::min(mixedBlockSize, pointNum - block);
+		const float *x = xs.data() + block;
+		const float *y = ys.data() + block;
+
+		// 1 above the curve, 0 below, 2 undecided; the loop has no branches and vectorizes
+		for (int i = 0; i < blockSize; i++)
+		{
+			float p = coefficients[0];
+			float s = absCoefficients[0];
+			float ax = std::fabs(x[i]);
+			for (int k = 1; k < CoefNum; k++)
+			{
+				p = p * x[i] + coefficients[k];
+				s = s * ax + absCoefficients[k];
+			}
+			float r = y[i] - p;
+			float bound = boundFactor * (std::fabs(y[i]) + s) + boundMinimum;
+			sides[i] = r > bound ? 1 : (r < -bound ? 0 : 2);
+		}
+
+		for (int i = 0; i < blockSize; i++)
+		{
+			bool isAbove = sides[i] == 2 ? fcnPtr(set.getPointAt(block + i).getX(), set.getPointAt(block + i).getY(), curve) :
+				sides[i] == 1;
+			score += isAbove == set.isPositive() ? weights[block + i] : 0;
+			retested += sides[i] == 2;
+		}
+	}
+
+	return score;
+}
+
+double calculateMixedFitness(const Curve &curve, const PointSet &positiveSet, const PointSet &negativeSet,
+	MixedPrecisionCounts *counts)
+{
+	bool(*fcnPtr)(double x, double y, const Curve &curve) = getCurveFunction(curve.getDegree());
+	if (fcnPtr == nullptr)
+	{
+		std::cout << "Fitness calculation is impossible for given degree\n";
+		return 0.0;
+	}
+
+	// Coefficients are small integers, exact in float32
+	ConstView<const Coefficient*> c = curve.getCoefficients();
+	float coefficients[6];
+	float absCoefficients[6];
+	for (unsigned int k = 0; k < c.size(); k++)
+	{
+		coefficients[k] = static_cast<float>(c[k]->getNumber());
+		absCoefficients[k] = std::fabs(coefficients[k]);
+	}
+
+	int fitnessScore = 0;
+	int retested = 0;
+	const PointSet *sets[] = { &positiveSet, &negativeSet };
+	for (const PointSet *set : sets)
+		switch (c.size())
+		{
+			case 2:
+				fitnessScore += countMixedCorrect<2>(coefficients, absCoefficients, *set, fcnPtr, curve, retested);
+				break;
+			case 3:
+				fitnessScore += countMixedCorrect<3>(coefficients, absCoefficients, *set, fcnPtr, curve, retested);
+				break;
+			case 4:
+				fitnessScore += countMixedCorrect<4>(coefficients, absCoefficients, *set, fcnPtr, curve, retested);
+				break;
+			case 5:
+				fitnessScore += countMixedCorrect<5>(coefficients, absCoefficients, *set, fcnPtr, curve, retested);
+				break;
+			default:
+				fitnessScore += countMixedCorrect<6>(coefficients, absCoefficients, *set, fcnPtr, curve, retested);
+				break;
+		}
+
+	// One update per call keeps the shared counters out of the point loop
+	if (counts != nullptr)
+	{
+		counts->testedPoints.fetch_add(positiveSet.getPointsetSize() + negativeSet.getPointsetSize(), std::memory_order_relaxed);
+		counts->retestedPoints.fetch_add(retested, std::memory_order_relaxed);
+	}
+	return (double)fitnessScore / (positiveSet.getTotalWeight() + negativeSet.getTotalWeight());
+}
+
+double updateFitness(Curve &curve, const PointSet &positiveSet, const PointSet &negativeSet)
+{
+	bool(*fcnPtr)(double x, double y, const Curve &curve) = getCurveFunction(curve.getDegree());
+	if (fcnPtr == nullptr)
+	{
+		std::cout << "Fitness calculation is impossible for given degree\n";
+		return 0.0;
+	}
+
+	ConstView<Point> positives = positiveSet.getPoints();
+	ConstView<Point> negatives = negativeSet.getPoints();
+	int positivesetSize = positives.size();
+	int negativesetSize = negatives.size();
+
+	int positiveHits = 0, negativeHits = 0;
+	for (int i = curve.getTestedPositive(); i < positivesetSize; i++)
+		positiveHits += fcnPtr(positives[i].getX(), positives[i].getY(), curve);
+	for (int i = curve.getTestedNegative(); i < negativesetSize; i++)
+		negativeHits += !fcnPtr(negatives[i].getX(), negatives[i].getY(), curve);
+
+	curve.addHits(positiveHits, positivesetSize - curve.getTestedPositive(),
+		negativeHits, negativesetSize - curve.getTestedNegative());
+
+	int totalSize = positivesetSize + negativesetSize;
+	double finalFitness = totalSize == 0 ? 0.0 : (double)curve.getHitCount() / totalSize;
+	curve.setFitness(finalFitness);
+	return finalFitness;
+}
+
+CutoffFitness calculateFitnessWithCutoff(const Curve &curve, const PointSet &positiveSet, const PointSet &negativeSet, double cutoff)
+{
+	const int blockSize = 64;
+
+	bool(*fcnPtr)(double x, double y, const Curve &curve) = getCurveFunction(curve.getDegree());
+	if (fcnPtr == nullptr)
+	{
+		std::cout << "Fitness calculation is impossible for given degree\n";
+		return CutoffFitness{ true, 0.0, 0 };
+	}
+
+	ConstView<Point> positives = positiveSet.getPoints();
+	ConstView<Point> negatives = negativeSet.getPoints();
+	ConstView<int> positiveWeights = positiveSet.getWeights();
+	ConstView<int> negativeWeights = negativeSet.getWeights();
+	int positivesetSize = positives.size();
+	int negativesetSize = negatives.size();
+	int totalSize = positiveSet.getTotalWeight() + negativeSet.getTotalWeight();
+
+	// The number of misses the curve can afford and still reach the cutoff, counted in original points
+	int allowedMisses = totalSize - static_cast<int>(ceil(cutoff * totalSize - 1e-9));
+
+	int fitnessScore = 0, tested = 0;
+	int p = 0, n = 0;
+	while (p < positivesetSize || n < negativesetSize)
+	{
+		for (int end = std::min(p + blockSize, positivesetSize); p < end; p++)
+		{
+			fitnessScore += fcnPtr(positives[p].getX(), positives[p].getY(), curve) ? positiveWeights[p] : 0;
+			tested += positiveWeights[p];
+		}
+
+		for (int end = std::min(n + blockSize, negativesetSize); n < end; n++)
+		{
+			fitnessScore += !fcnPtr(negatives[n].getX(), negatives[n].getY(), curve) ? negativeWeights[n] : 0;
+			tested += negativeWeights[n];
+		}
+
+		int misses = tested - fitnessScore;
+		if (misses > allowedMisses)
+			return CutoffFitness{ true, (double)(totalSize - misses) / totalSize, p + n };
+	}
+
+	return CutoffFitness{ false, (double)fitnessScore / totalSize, p + n };
+}
+
+void sortPointsByDifficulty(PointSet &positiveSet, PointSet &negativeSet, std::vector<int> &difficulty)
+{
+	int positivesetSize = positiveSet.getPointsetSize();
+	int negativesetSize = negativeSet.getPointsetSize();
+
+	std::vector<int> positiveOrder, negativeOrder;
+	for (int i = 0; i < positivesetSize; i++)
+		positiveOrder.push_back(i);
+	for (int i = 0; i < negativesetSize; i++)
+		negativeOrder.push_back(i);
+
+	std::stable_sort(positiveOrder.begin(), positiveOrder.end(),
+		[&difficulty](int a, int b) { return difficulty.at(a) > difficulty.at(b); });
+	std::stable_sort(negativeOrder.begin(), negativeOrder.end(),
+		[&difficulty, positivesetSize](int a, int b)
+		{ return difficulty.at(positivesetSize + a) > difficulty.at(positivesetSize + b); });
+
+	positiveSet.reorderPoints(positiveOrder);
+	negativeSet.reorderPoints(negativeOrder);
+}
+
+Curve* copyCurve(const Curve &curve)
+{
+	std::vector<Coefficient*> *coefficients = new std::vector<Coefficient*>();
+	for (int i = 0; i <= curve.getDegree(); i++)
+		coefficients->push_back(new Coefficient(curve.getCoefficientAt(i)->getNumber()));
+
+	Curve *copy = new Curve(coefficients);
+	if (curve.isFitnessExact())
+		copy->setFitness(curve.getFitness());
+	else
+		copy->setEstimatedFitness(curve.getFitness());
+	return copy;
+}
+
+void classifyBatch(const std::vector<double> &coefficients, const double *x, const double *y, unsigned char *labels, int count)
+{
+	const int blockSize = 256;
+	const double *c = coefficients.data();
+	int coefNum = static_cast<int>(coefficients.size());
+	double value[blockSize];
+
+	// Horner evaluation block by block, the point loop is innermost so it vectorizes
+	for (int start = 0; start < count; start += blockSize)
+	{
+		int blockCount = std::min(blockSize, count - start);
+		const double *bx = x + start;
+		const double *by = y + start;
+
+		for (int i = 0; i < blockCount; i++)
+			value[i] = c[0];
+		for (int k = 1; k < coefNum; k++)
+			for (int i = 0; i < blockCount; i++)
+				value[i] = value[i] * bx[i] + c[k];
+		for (int i = 0; i < blockCount; i++)
+			labels[start + i] = by[i] > value[i];
+	}
+}
+
+bool saveCurveCheckpoint(std::vector<double> &coefficients, std::string filename)
+{
+	std::string temporary = filename + ".tmp";
+	std::ofstream outf(temporary);
+	if (!outf)
+	{
+		std::cerr << "Cannot open " << temporary << " for writing" << std::endl;
+		return false;
+	}
+
+	outf.precision(17);
+	outf << coefficients.size() - 1 << '\n';
+	for (unsigned int i = 0; i < coefficients.size(); i++)
+		outf << coefficients.at(i) << (i + 1 < coefficients.size() ? ' ' : '\n');
+	outf.close();
+
+	return std::rename(temporary.c_str(), filename.c_str()) == 0;
+}
+
+bool loadCurveCheckpoint(std::string filename, std::vector<double> &coefficients)
+{
+	std::ifstream inf(filename);
+	if (!inf)
+	{
+		std::cerr << "Cannot open " << filename << " for reading" << std::endl;
+		return false;
+	}
+
+	int degree;
+	if (!(inf >> degree) || degree < 0)
+		return false;
+
+	std::vector<double> loaded(degree + 1);
+	for (int i = 0; i <= degree; i++)
+		if (!(inf >> loaded.at(i)))
+			return false;
+
+	coefficients = loaded;
+	return true;
+}
+
+long long calculateSampledFitness(Population &population, const PointSet &positiveSet, const PointSet &negativeSet,
+	int initialSampleSize, int fullEvaluationCount, double confidence)
+{
+	int populationSize = population.getPopulationSize();
+	ConstView<Point> positives = positiveSet.getPoints();
+	ConstView<Point> negatives = negativeSet.getPoints();
+	int positivesetSize = positives.size();
+	int negativesetSize = negatives.size();
+	int totalSize = positivesetSize + negativesetSize;
+
+	// Share of each stratum in the full fitness
+	double positiveWeight = (double)positivesetSize / totalSize;
+	double negativeWeight = (double)negativesetSize / totalSize;
+
+	// Per candidate hits and number of tested points in each stratum
+	std::vector<int> positiveHits(populationSize, 0), negativeHits(populationSize, 0);
+	std::vector<double> estimates(populationSize, 0.0);
+	std::vector<int> alive;
+	for (int i = 0; i < populationSize; i++)
+		alive.push_back(i);
+
+	int testedPositive = 0, testedNegative = 0;
+	int sampleSize = initialSampleSize;
+	long long pointsTested = 0;
+
+	// Race while the sample is cheaper than the full sets and there is something to cull
+	while (sampleSize < totalSize && (int)alive.size() > fullEvaluationCount)
+	{
+		// Stratified sample: every set gets a share proportional to its size, at least one point of a non-empty set
+		// and none of an empty one
+		int positiveSample = positivesetSize > 0 ? std::max(1, static_cast<int>(sampleSize * positiveWeight)) : 0;
+		int negativeSample = negativesetSize > 0 ? std::max(1, sampleSize - positiveSample) : 0;
+
+		// All candidates are compared on the same points to reduce variance of the comparison
+		std::vector<int> positiveIdx, negativeIdx;
+		for (int s = 0; s < positiveSample; s++)
+			positiveIdx.push_back(getRandomNumber(0, positivesetSize - 1));
+		for (int s = 0; s < negativeSample; s++)
+			negativeIdx.push_back(getRandomNumber(0, negativesetSize - 1));
+		testedPositive += positiveSample;
+		testedNegative += negativeSample;
+		pointsTested += static_cast<long long>(alive.size()) * (positiveSample + negativeSample);
+
+		for (int c : alive)
+		{
+			Curve &curve = *population.getCurveAt(c);
+			bool(*fcnPtr)(double x, double y, const Curve &curve) = getCurveFunction(curve.getDegree());
+			if (fcnPtr == nullptr)
+				continue;
+
+			for (int idx : positiveIdx)
+				if (fcnPtr(positives[idx].getX(), positives[idx].getY(), curve))
+					positiveHits.at(c)++;
+			for (int idx : negativeIdx)
+				if (!(fcnPtr(negatives[idx].getX(), negatives[idx].getY(), curve)))
+					negativeHits.at(c)++;
+
+			estimates.at(c) = (testedPositive > 0 ? positiveWeight * positiveHits.at(c) / testedPositive : 0.0) +
+				(testedNegative > 0 ? negativeWeight * negativeHits.at(c) / testedNegative : 0.0);
+			population.getCurveAt(c)->setEstimatedFitness(estimates.at(c));
+		}
+
+		// Hoeffding radius for the accuracy estimated on the points tested so far
+		double radius = sqrt(log(2.0 / (1.0 - confidence)) / (2.0 * (testedPositive + testedNegative)));
+
+		// Racing: drop candidates whose upper bound is below the best lower bound
+		double bestLowerBound = 0.0;
+		for (int c : alive)
+			bestLowerBound = std::max(bestLowerBound, estimates.at(c) - radius);
+
+		std::vector<int> competitive;
+		for (int c : alive)
+			if (estimates.at(c) + radius >= bestLowerBound)
+				competitive.push_back(c);
+
+		// Successive halving: keep at most half of the survivors, but never less than the full evaluation count
+		std::sort(competitive.begin(), competitive.end(),
+			[&estimates](int a, int b) { return estimates.at(a) > estimates.at(b); });
+		unsigned int keep = std::max(static_cast<unsigned int>(fullEvaluationCount),
+			static_cast<unsigned int>((alive.size() + 1) / 2));
+		if (competitive.size() > keep)
+			competitive.resize(keep);
+
+		alive = competitive;
+		sampleSize *= 2;
+	}
+
+	// Candidates which stayed competitive are scored exactly
+	for (int c : alive)
+		population.getCurveAt(c)->setFitness(calculateFitness(*population.getCurveAt(c), positiveSet, negativeSet));
+	return pointsTested + static_cast<long long>(alive.size()) * totalSize;
+}
+
+bool isPointPositiveFirstDegree(double x, double y, const Curve &curve)
 {
-	return (y > (curve.getCoefficientAt(0)->getNumber() * x +
-		curve.getCoefficientAt(1)->getNumber()));
+	ConstView<const Coefficient*> c = curve.getCoefficients();
+	return (y > (c[0]->getNumber() * x +
+		c[1]->getNumber()));
 }
 
-bool isPointPositiveSecondDegree(double x, double y, Curve &curve)
+bool isPointPositiveSecondDegree(double x, double y, const Curve &curve)
 {
-	return (y > (curve.getCoefficientAt(0)->getNumber() * pow(x, 2.0) +
-		curve.getCoefficientAt(1)->getNumber() * x + curve.getCoefficientAt(2)->getNumber()));
+	ConstView<const Coefficient*> c = curve.getCoefficients();
+	return (y > (c[0]->getNumber() * pow(x, 2.0) +
+		c[1]->getNumber() * x + c[2]->getNumber()));
 }
 
-bool isPointPositiveThirdDegree(double x, double y, Curve &curve)
+bool isPointPositiveThirdDegree(double x, double y, const Curve &curve)
 {
-	return (y > (curve.getCoefficientAt(0)->getNumber() * pow(x, 3.0) +
-		curve.getCoefficientAt(1)->getNumber() * pow(x, 2.0) + curve.getCoefficientAt(2)->getNumber() * x
-		+ curve.getCoefficientAt(3)->getNumber()));
+	ConstView<const Coefficient*> c = curve.getCoefficients();
+	return (y > (c[0]->getNumber() * pow(x, 3.0) +
+		c[1]->getNumber() * pow(x, 2.0) + c[2]->getNumber() * x
+		+ c[3]->getNumber()));
 }
 
-bool isPointPositiveFourthDegree(double x, double y, Curve &curve)
+bool isPointPositiveFourthDegree(double x, double y, const Curve &curve)
 {
-	return (y > (curve.getCoefficientAt(0)->getNumber() * pow(x, 4.0) +
-		curve.getCoefficientAt(1)->getNumber() * pow(x, 3.0) + curve.getCoefficientAt(2)->getNumber() * pow(x, 2.0)
-		+ curve.getCoefficientAt(3)->getNumber() * x + curve.getCoefficientAt(4)->getNumber()));
+	ConstView<const Coefficient*> c = curve.getCoefficients();
+	return (y > (c[0]->getNumber() * pow(x, 4.0) +
+		c[1]->getNumber() * pow(x, 3.0) + c[2]->getNumber() * pow(x, 2.0)
+		+ c[3]->getNumber() * x + c[4]->getNumber()));
 }
 
-bool isPointPositiveFifthDegree(double x, double y, Curve &curve)
+bool isPointPositiveFifthDegree(double x, double y, const Curve &curve)
 {
-	return (y > (curve.getCoefficientAt(0)->getNumber() * pow(x, 5.0) +
-		curve.getCoefficientAt(1)->getNumber() * pow(x, 4.0) + curve.getCoefficientAt(2)->getNumber() * pow(x, 3.0)
-		+ curve.getCoefficientAt(3)->getNumber() * pow(x, 2.0) + curve.getCoefficientAt(4)->getNumber() * x + 
-		curve.getCoefficientAt(5)->getNumber()));
+	ConstView<const Coefficient*> c = curve.getCoefficients();
+	return (y > (c[0]->getNumber() * pow(x, 5.0) +
+		c[1]->getNumber() * pow(x, 4.0) + c[2]->getNumber() * pow(x, 3.0)
+		+ c[3]->getNumber() * pow(x, 2.0) + c[4]->getNumber() * x + 
+		c[5]->getNumber()));
 }
 
 //std::vector<Curve*> createMatingPool(Population &population)
@@ -5,13 +5,73 @@
 #include "Coefficient.h"
 #include "Curve.h"
 #include "Population.h"
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
 #include <vector>
+#include <string>
+
+// A function for selecting the point test of curve basing on the degree of polynomial, nullptr if degree is not supported
+bool(*getCurveFunction(int curveDegree))(double x, double y, const Curve &curve);
 
 // A function for calculating fitness of taken curve 
-double calculateFitness(Curve &curve, PointSet &positiveSet, PointSet &negativeSet);
+double calculateFitness(const Curve &curve, const PointSet &positiveSet, const PointSet &negativeSet);
+
+// Points calculateMixedFitness has classified for its caller (a run or a check), and how many of them needed the double test
+struct MixedPrecisionCounts
+{
+	std::atomic<long long> testedPoints{ 0 };
+	std::atomic<long long> retestedPoints{ 0 };
+};
+
+// A function for calculating the same fitness as calculateFitness from the float32 copies of the points.
+// A point is decided in float32 when its residual exceeds the rounding error bound, otherwise by the double test.
+// The classified points are added to counts unless it is nullptr
+double calculateMixedFitness(const Curve &curve, const PointSet &positiveSet, const PointSet &negativeSet,
+	MixedPrecisionCounts *counts);
+
+// Result of fitness calculation against a cutoff. When the curve can not reach the cutoff
+// the scan is aborted and fitness holds the upper bound known at that moment
+struct CutoffFitness
+{
+	bool isBelowCutoff;
+	double fitness;
+	int testedPoints;
+};
+
+// A function for calculating fitness incrementally, only points appended to the sets after the previous call are tested.
+// Hit counts are kept by the curve, so a new curve is tested on every point
+double updateFitness(Curve &curve, const PointSet &positiveSet, const PointSet &negativeSet);
+
+// A function for calculating fitness of taken curve which stops as soon as the number of misclassified points
+// makes reaching the cutoff impossible, points are checked by blocks alternating the positive and negative set
+CutoffFitness calculateFitnessWithCutoff(const Curve &curve, const PointSet &positiveSet, const PointSet &negativeSet, double cutoff);
+
+// A function for reordering both point sets so that points misclassified by most individuals go first,
+// difficulty is indexed as in ClassificationBits (positive points first, then negative)
+void sortPointsByDifficulty(PointSet &positiveSet, PointSet &negativeSet, std::vector<int> &difficulty);
+
+// A function for making a deep copy of the curve together with its fitness
+Curve* copyCurve(const Curve &curve);
+
+// A function for classifying a batch of points against the curve given by coefficients, label is 1 when the point
+// is on the positive side (above the curve). Points are passed as separate x and y arrays so the loop vectorizes
+void classifyBatch(const std::vector<double> &coefficients, const double *x, const double *y, unsigned char *labels, int count);
+
+// Functions for saving and loading coefficients of the curve, first coefficient belongs to the highest power.
+// The checkpoint is written to a temporary file and renamed, so readers never see a partial file
+bool saveCurveCheckpoint(std::vector<double> &coefficients, std::string filename);
+bool loadCurveCheckpoint(std::string filename, std::vector<double> &coefficients);
+
+// A function for calculating fitness of the whole population on stratified random subsamples of the point sets.
+// Candidates race on growing samples (successive halving with Hoeffding bounds), only the ones still competitive
+// at the end are scored on the full sets, the rest keep their sampled estimate (marked as not exact).
+// The race is sublinear in the points, the exact pass is not: at least fullEvaluationCount candidates still
+// scan all N points, so a generation costs O(fullEvaluationCount * N) plus the samples. Returns the number of points
+// the candidates were tested on, sample points counted once per candidate
+long long calculateSampledFitness(Population &population, const PointSet &positiveSet, const PointSet &negativeSet,
+	int initialSampleSize, int fullEvaluationCount, double confidence);
 
 // A function for creating mating pool basing on the fitness of curve
 // A mating pool is the array of object pointers populated according to fitness probability
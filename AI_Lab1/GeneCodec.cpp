@@ -0,0 +1,52 @@
+#include "stdafx.h"
+#include "GeneCodec.h"
+
+bool parseGeneCodec(const std::string &name, GeneCodec &codec)
+{
+	if (name == "twos")
+		codec = GeneCodec::TwosComplement;
+	else if (name == "gray")
+		codec = GeneCodec::Gray;
+	else if (name == "offset")
+		codec = GeneCodec::OffsetBinary;
+	else if (name == "creep")
+		codec = GeneCodec::DirectCreep;
+	else
+		return false;
+	return true;
+}
+
+// Code of the number in the given codec
+uint8_t encodeNumber(GeneCodec codec, int number)
+{
+	uint8_t offset = static_cast<uint8_t>(number + 128);
+	switch (codec)
+	{
+		case GeneCodec::Gray:
+			return offset ^ (offset >> 1);
+		case GeneCodec::OffsetBinary:
+			return offset;
+		default:
+			return static_cast<uint8_t>(number);
+	}
+}
+
+GeneCodecTable buildGeneCodecTable(GeneCodec codec)
+{
+	GeneCodecTable table;
+	for (int number = -128; number < 128; number++)
+	{
+		uint8_t code = encodeNumber(codec, number);
+		table.encode[number + 128] = code;
+		table.decode[code] = static_cast<int8_t>(number);
+	}
+	return table;
+}
+
+const GeneCodecTable& getGeneCodecTable(GeneCodec codec)
+{
+	static const GeneCodecTable tables[] = { buildGeneCodecTable(GeneCodec::TwosComplement),
+		buildGeneCodecTable(GeneCodec::Gray), buildGeneCodecTable(GeneCodec::OffsetBinary),
+		buildGeneCodecTable(GeneCodec::DirectCreep) };
+	return tables[static_cast<int>(codec)];
+}
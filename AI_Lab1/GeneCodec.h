@@ -0,0 +1,25 @@
+#pragma once
+#include "stdafx.h"
+#include <cstdint>
+#include <string>
+
+// Bit representation of an 8-bit gene in the packed chromosome
+enum class GeneCodec
+{
+	TwosComplement,	// plain two's complement, mutation keeps the last bit set (as Coefficient::mutateCoefficient)
+	Gray,			// reflected Gray code of the offset value, neighbouring numbers differ in one bit
+	OffsetBinary,	// number + 128, the order of codes follows the order of numbers
+	DirectCreep		// number stored as is and mutated by adding a small random step
+};
+
+// Encode and decode tables of a codec, encode is indexed by number + 128
+struct GeneCodecTable
+{
+	uint8_t encode[256];
+	int8_t decode[256];
+};
+
+bool parseGeneCodec(const std::string &name, GeneCodec &codec);
+
+// Tables are built once on the first call
+const GeneCodecTable& getGeneCodecTable(GeneCodec codec);
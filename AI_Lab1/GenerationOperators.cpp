@@ -0,0 +1,252 @@
+#include "stdafx.h"
+#include "GenerationOperators.h"
+#include "Coefficient.h"
+#include "RandomNumberGenerator.h"
+#include <algorithm>
+#include <cmath>
+
+// Rates from this one on select mutated children with bit masks instead of geometric skips
+const double denseMutationRate = 0.25;
+
+// Bits of the mutation probability used to build the Bernoulli masks
+const int probabilityBits = 16;
+
+std::vector<ParentPair> chooseParentPairs(Population &population, int childNum)
+{
+	int populationSize = population.getPopulationSize();
+
+	// Sum of fitnesses of the individuals before each one, ChooseParent returns the first individual whose
+	// preceding sum reaches the random number
+	std::vector<double> precedingSums(populationSize);
+	double fitnessSum = 0;
+	for (int i = 0; i < populationSize; i++)
+	{
+		precedingSums[i] = fitnessSum;
+		fitnessSum += population.getCurveAt(i)->getFitness();
+	}
+
+	std::vector<ParentPair> pairs(childNum);
+	for (int i = 0; i < childNum; i++)
+	{
+		int parents[2];
+		for (int k = 0; k < 2; k++)
+		{
+			double randomNum = getRandomNumber(0.0, fitnessSum);
+			int idx = static_cast<int>(std::lower_bound(precedingSums.begin(), precedingSums.end(), randomNum) -
+				precedingSums.begin());
+			parents[k] = std::min(idx, populationSize - 1);
+		}
+		pairs[i] = ParentPair{ parents[0], parents[1] };
+	}
+	return pairs;
+}
+
+GenerationOperators::GenerationOperators(const RunConfig &config)
+	: m_minCoefficient(std::max(config.minCoefficient, -128)), m_maxCoefficient(std::min(config.maxCoefficient, 127)),
+	m_creepStep(config.creepStep)
+{
+	m_geneNum = config.polynomialDegree + 1;
+	m_wordNum = (m_geneNum + 7) / 8;
+	m_crossoverMask.assign(m_wordNum, 0);
+	m_flipMask.assign(m_wordNum, 0);
+	m_lastBitMask.assign(m_wordNum, 0);
+
+	if (!parseGeneCodec(config.geneCodec, m_codec))
+		m_codec = GeneCodec::TwosComplement;
+	m_table = &getGeneCodecTable(m_codec);
+
+	// Genes before the crossover point come from the first parent. Two's complement mutation may flip any bit
+	// of a gene except the last one, which is then set to exclude zero (as Coefficient::mutateCoefficient does).
+	// Other codecs may flip any bit
+	bool keepLastBit = m_codec == GeneCodec::TwosComplement;
+	int crossoverPoint = static_cast<int>(floor(m_geneNum * config.crossoverProportion));
+	for (int j = 0; j < m_geneNum; j++)
+	{
+		int shift = 8 * (j % 8);
+		if (j < crossoverPoint)
+			m_crossoverMask[j / 8] |= static_cast<uint64_t>(0xFF) << shift;
+		m_flipMask[j / 8] |= static_cast<uint64_t>(keepLastBit ? 0xFE : 0xFF) << shift;
+		if (keepLastBit)
+			m_lastBitMask[j / 8] |= static_cast<uint64_t>(0x01) << shift;
+	}
+
+	// Seeded from the generator of the calling thread, so seeded runs stay reproducible
+	uint64_t seed = static_cast<uint64_t>(getRandomNumber(0, 65535)) << 16 | getRandomNumber(0, 65535);
+	m_random.seed(seed);
+}
+
+GenerationOperators::~GenerationOperators()
+{
+
+}
+
+// Packs genes of every individual encoded by the codec table, gene j goes to byte j % 8 of word j / 8
+void GenerationOperators::packPopulation(Population &population)
+{
+	int populationSize = population.getPopulationSize();
+	m_parents.assign(static_cast<size_t>(populationSize) * m_wordNum, 0);
+
+	for (int i = 0; i < populationSize; i++)
+	{
+		ConstView<const Coefficient*> coefficients = population.getCurveAt(i)->getCoefficients();
+		uint64_t *words = &m_parents[static_cast<size_t>(i) * m_wordNum];
+		for (int j = 0; j < m_geneNum; j++)
+		{
+			// The configured range fits 8 bits, a wider number would only come from outside the run
+			int number = std::max(-128, std::min(127, coefficients[j]->getNumber()));
+			uint8_t gene = m_table->encode[number + 128];
+			words[j / 8] |= static_cast<uint64_t>(gene) << (8 * (j % 8));
+		}
+	}
+}
+
+void GenerationOperators::mutateChild(int child)
+{
+	if (m_codec == GeneCodec::DirectCreep)
+	{
+		creepChild(child);
+		return;
+	}
+
+	uint64_t *words = &m_children[static_cast<size_t>(child) * m_wordNum];
+	// Every bit flips with probability 1/4 (the AND of two random words), bitMutationProbability of
+	// Coefficient::mutateCoefficient
+	if (m_codec == GeneCodec::TwosComplement)
+	{
+		for (int w = 0; w < m_wordNum; w++)
+			words[w] = (words[w] ^ (m_random() & m_random() & m_flipMask[w])) | m_lastBitMask[w];
+		return;
+	}
+
+	// Every bit flips with probability 1/8, about one bit per gene, so the step stays local in the codec.
+	// A gene which would leave the coefficient range, or a leading coefficient which would become zero,
+	// keeps its code, as creep limits its steps to the range
+	for (int w = 0; w < m_wordNum; w++)
+	{
+		uint64_t flipped = words[w] ^ (m_random() & m_random() & m_random() & m_flipMask[w]);
+		for (int j = 8 * w; j < std::min(m_geneNum, 8 * w + 8); j++)
+		{
+			int shift = 8 * (j % 8);
+			int number = m_table->decode[static_cast<uint8_t>(flipped >> shift)];
+			if (number < m_minCoefficient || number > m_maxCoefficient || (j == 0 && number == 0))
+				flipped = (flipped & ~(static_cast<uint64_t>(0xFF) << shift)) | (words[w] & static_cast<uint64_t>(0xFF) << shift);
+		}
+		words[w] = flipped;
+	}
+}
+
+// Adds a uniform step from [-creepStep, creepStep] to every gene, limited to the coefficient range
+void GenerationOperators::creepChild(int child)
+{
+	uint64_t *words = &m_children[static_cast<size_t>(child) * m_wordNum];
+	std::uniform_int_distribution<int> step(-m_creepStep, m_creepStep);
+	for (int j = 0; j < m_geneNum; j++)
+	{
+		int shift = 8 * (j % 8);
+		int number = m_table->decode[static_cast<uint8_t>(words[j / 8] >> shift)];
+		int moved = std::max(m_minCoefficient, std::min(m_maxCoefficient, number + step(m_random)));
+		if (j == 0 && moved == 0)
+			continue;
+		words[j / 8] = (words[j / 8] & ~(static_cast<uint64_t>(0xFF) << shift)) |
+			static_cast<uint64_t>(m_table->encode[moved + 128]) << shift;
+	}
+}
+
+// Geometric skip sampling: the gap to the next mutated child is drawn directly, one draw per mutation
+void GenerationOperators::mutateSparse(int childNum, double mutationRate)
+{
+	if (mutationRate <= 0.0)
+		return;
+
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	double logKeep = log(1.0 - mutationRate);
+	int child = -1;
+	while (true)
+	{
+		double u = 1.0 - unit(m_random);
+		double skip = floor(log(u) / logKeep);
+		if (skip >= childNum - child - 1)
+			break;
+		child += static_cast<int>(skip) + 1;
+		mutateChild(child);
+	}
+}
+
+// Bernoulli masks for 64 children at a time. The probability is written in binary, and random words are
+// combined from its lowest bit up: AND for 0, OR for 1, so every bit of the mask is set with that probability
+void GenerationOperators::mutateDense(int childNum, double mutationRate)
+{
+	uint64_t probability = static_cast<uint64_t>(std::min(mutationRate, 1.0) * (1 << probabilityBits) + 0.5);
+
+	for (int block = 0; block < childNum; block += 64)
+	{
+		uint64_t mask = 0;
+		if (probability >> probabilityBits)
+			mask = ~static_cast<uint64_t>(0);
+		else
+			for (int b = 0; b < probabilityBits; b++)
+				mask = (probability >> b) & 1 ? mask | m_random() : mask & m_random();
+
+		int blockSize = std::min(64, childNum - block);
+		for (int k = 0; k < blockSize; k++)
+			if (mask >> k & 1)
+				mutateChild(block + k);
+	}
+}
+
+std::vector<Curve*>* GenerationOperators::breed(Population &population, const std::vector<ParentPair> &pairs,
+	double mutationRate)
+{
+	packPopulation(population);
+
+	int childNum = static_cast<int>(pairs.size());
+	m_children.resize(static_cast<size_t>(childNum) * m_wordNum);
+
+	for (int i = 0; i < childNum; i++)
+	{
+		const uint64_t *a = &m_parents[static_cast<size_t>(pairs[i].first) * m_wordNum];
+		const uint64_t *b = &m_parents[static_cast<size_t>(pairs[i].second) * m_wordNum];
+		uint64_t *child = &m_children[static_cast<size_t>(i) * m_wordNum];
+		for (int w = 0; w < m_wordNum; w++)
+			child[w] = (a[w] & m_crossoverMask[w]) | (b[w] & ~m_crossoverMask[w]);
+	}
+
+	if (mutationRate < denseMutationRate)
+		mutateSparse(childNum, mutationRate);
+	else
+		mutateDense(childNum, mutationRate);
+
+	// Unpack children into curves through the decode table
+	std::vector<Curve*> *children = new std::vector<Curve*>();
+	children->reserve(childNum);
+	for (int i = 0; i < childNum; i++)
+	{
+		const uint64_t *words = &m_children[static_cast<size_t>(i) * m_wordNum];
+		std::vector<Coefficient*> *coefficients = new std::vector<Coefficient*>();
+		coefficients->reserve(m_geneNum);
+		for (int j = 0; j < m_geneNum; j++)
+		{
+			int gene = m_table->decode[static_cast<uint8_t>(words[j / 8] >> (8 * (j % 8)))];
+			coefficients->push_back(new Coefficient(gene));
+		}
+		children->push_back(new Curve(coefficients));
+	}
+	return children;
+}
+
+// Children of the last breed as 8-bit two's complement genes (the history log layout), the packed words
+// themselves for the two's complement codec and decoded through the table for the others
+ConstView<uint64_t> GenerationOperators::getChildGenomes()
+{
+	if (m_codec == GeneCodec::TwosComplement)
+		return m_children;
+
+	m_childGenomes.assign(m_children.size(), 0);
+	for (size_t w = 0; w < m_children.size(); w++)
+		for (int b = 0; b < 8 && 8 * static_cast<int>(w % m_wordNum) + b < m_geneNum; b++)
+		{
+			uint8_t gene = static_cast<uint8_t>(m_table->decode[static_cast<uint8_t>(m_children[w] >> (8 * b))]);
+			m_childGenomes[w] |= static_cast<uint64_t>(gene) << (8 * b);
+		}
+	return m_childGenomes;
+}
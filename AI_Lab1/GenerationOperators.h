@@ -0,0 +1,57 @@
+#pragma once
+#include "stdafx.h"
+#include "ConstView.h"
+#include "Curve.h"
+#include "GeneCodec.h"
+#include "Population.h"
+#include "RunConfig.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Indices of both parents of one child in the current population
+struct ParentPair
+{
+	int first;
+	int second;
+};
+
+// Roulette wheel selection of parents for a whole generation, the same rule as ChooseParent
+// but searched in prefix sums of fitness
+std::vector<ParentPair> chooseParentPairs(Population &population, int childNum);
+
+// Crossover and mutation of a whole generation at once. Chromosomes are packed into 64-bit words,
+// eight 8-bit genes per word, so a child is built as (a & m) | (b & ~m) with the one-point crossover mask m
+// and mutated by XOR with a random word. Children to mutate are picked by geometric skips for low rates
+// and by 64-wide Bernoulli bit masks for high rates, so the cost does not depend on the number of genes.
+// A child is mutated and a two's complement bit flipped with the probabilities of the child by child operators.
+// Genes are stored in the configured codec as 8 bits, the creep codec mutates numbers instead of bits
+class GenerationOperators
+{
+	int m_geneNum;
+	int m_wordNum;
+	GeneCodec m_codec;
+	const GeneCodecTable *m_table;
+	int m_minCoefficient;
+	int m_maxCoefficient;
+	int m_creepStep;
+	std::vector<uint64_t> m_crossoverMask;
+	std::vector<uint64_t> m_flipMask;
+	std::vector<uint64_t> m_lastBitMask;
+	std::vector<uint64_t> m_parents;
+	std::vector<uint64_t> m_children;
+	std::vector<uint64_t> m_childGenomes;
+	std::mt19937_64 m_random;
+
+	void packPopulation(Population &population);
+	void mutateChild(int child);
+	void creepChild(int child);
+	void mutateSparse(int childNum, double mutationRate);
+	void mutateDense(int childNum, double mutationRate);
+
+public:
+	GenerationOperators(const RunConfig &config);
+	std::vector<Curve*>* breed(Population &population, const std::vector<ParentPair> &pairs, double mutationRate);
+	ConstView<uint64_t> getChildGenomes();
+	~GenerationOperators();
+};
@@ -0,0 +1,575 @@
+#include "stdafx.h"
+#include "GeneticAlgorithm.h"
+#include "Functions.h"
+#include "ClassificationBits.h"
+#include "GeneticEngine.h"
+#include "GenerationOperators.h"
+#include "HistoryLog.h"
+#include "LivePlotter.h"
+#include "MetricsServer.h"
+#include "PipelinedExecutor.h"
+#include "RandomNumberGenerator.h"
+
+RunResult CompiledGeneticAlgorithm(const RunConfig &config, PointSet &positiveSet, PointSet &negativeSet,
+	const SolveControl &control);
+int EvaluatePopulation(const RunConfig &config, Population &pop, PointSet &ppos, PointSet &pneg, std::vector<double> &diversity,
+	const SolveControl &control, long long &pointsTested, MixedPrecisionCounts *mixedCounts);
+RunResult SteadyStateGeneticAlgorithm(const RunConfig &config, PointSet &positiveSet, PointSet &negativeSet,
+	const SolveControl &control, LivePlotter *plotter, RunMetrics *metrics);
+bool UsePipeline(const RunConfig &config);
+int ChooseChildNum(const RunConfig &config, const SolveControl &control, long long evaluations, int generation);
+double GetBestCandidateFitness(Curve &curve, double bestfit, const PointSet &ppos, const PointSet &pneg);
+double GetMaxFitness(std::vector<double> &fitnesses);
+double GetMinFitness(std::vector<double> &fitnesses);
+double GetAvgFitness(std::vector<double> &fitnesses);
+
+RunResult GeneticAlgorithm(const RunConfig &config, PointSet &positiveSet, PointSet &negativeSet, const SolveControl *control,
+	LivePlotter *plotter, RunMetrics *metrics)
+{
+	// The run's own deadline, the caller's control may add cancellation and an outer deadline
+	SolveControl runControl(config.timeBudget, control);
+
+	if (config.useCompiledEngine)
+		return CompiledGeneticAlgorithm(config, positiveSet, negativeSet, runControl);
+	if (config.steadyState && UsePipeline(config))
+		return SteadyStateGeneticAlgorithm(config, positiveSet, negativeSet, runControl, plotter, metrics);
+
+	// Initialize statistical data
+	std::vector<double> bestFitness;
+	std::vector<double> worstFitness;
+	std::vector<double> avgFitness;
+	std::vector<double> popFitnesses;
+	std::vector<double> diversity;
+	std::vector<int> bestCoefficients{};
+	int bestGeneration = 0;
+	double bestfit = 0.0;
+	long long evaluations = 0;
+	bool isStopped = false;
+	long long pointNum = positiveSet.getPointsetSize() + negativeSet.getPointsetSize();
+	long long pointsTested = 0;
+	MixedPrecisionCounts *mixedCounts = metrics != nullptr ? metrics->getMixedCounts() : nullptr;
+	std::chrono::steady_clock::time_point phaseStart = std::chrono::steady_clock::now();
+	
+	// Itinialize initial best coefficients
+	for (int i = 0; i <= config.polynomialDegree; i++)
+		bestCoefficients.push_back(0);
+
+	// Initialise initial population, point sets are provided by the caller
+	PointSet *ppos = &positiveSet;
+	PointSet *pneg = &negativeSet;
+	Population *pop = new Population(config.populationSize, config.polynomialDegree, config.minCoefficient, config.maxCoefficient);
+	GenerationOperators *operators = new GenerationOperators(config);
+	PipelinedExecutor *executor = UsePipeline(config) ? new PipelinedExecutor(config, *ppos, *pneg, mixedCounts) : nullptr;
+
+	// Optional lineage of every generation, preallocated for the largest possible run
+	HistoryLog *history = nullptr;
+	if (!config.historyLog.empty())
+	{
+		history = new HistoryLog();
+		if (!history->open(config.historyLog, config.polynomialDegree + 1, config.maxGeneration + 1, config.populationSize))
+		{
+			delete history;
+			history = nullptr;
+		}
+	}
+
+	// Calculate fitness for current generation
+	int evaluated = EvaluatePopulation(config, *pop, *ppos, *pneg, diversity, runControl, pointsTested, mixedCounts);
+	evaluations += evaluated;
+	if (metrics != nullptr)
+	{
+		metrics->addEvaluations(evaluated, pointsTested);
+		metrics->addPhaseTime(EvaluationPhase, std::chrono::steady_clock::now() - phaseStart);
+	}
+	isStopped = evaluated < pop->getPopulationSize();
+	for (int i = 0; i < evaluated; i++)
+	{
+		Curve *currCurve = pop->getCurveAt(i);
+		double fitness = GetBestCandidateFitness(*currCurve, bestfit, *ppos, *pneg);
+		popFitnesses.push_back(fitness);
+
+		if (fitness > bestfit)
+		{
+			bestGeneration = pop->getGenerationNum();
+			bestfit = fitness;
+			currCurve->getDecimalCoefficients(bestCoefficients);
+		}
+		currCurve = nullptr;
+	}
+
+	// Order points hardest first so that rejected children are detected earlier
+	if (config.useFitnessCutoff && config.hardestPointsFirst && !isStopped)
+	{
+		std::vector<ClassificationBits*> results;
+		for (int i = 0; i < pop->getPopulationSize(); i++)
+			results.push_back(new ClassificationBits(*pop->getCurveAt(i), *ppos, *pneg));
+		std::vector<int> difficulty = calculatePointDifficulty(results);
+		sortPointsByDifficulty(*ppos, *pneg, difficulty);
+		for (unsigned int i = 0; i < results.size(); i++)
+			delete results.at(i);
+	}
+
+	// Set initial best, worst and average fitness;
+	if (!popFitnesses.empty())
+	{
+		bestFitness.push_back(GetMaxFitness(popFitnesses));
+		worstFitness.push_back(GetMinFitness(popFitnesses));
+		avgFitness.push_back(GetAvgFitness(popFitnesses));
+		if (history != nullptr)
+			history->appendPopulation(*pop, pop->getGenerationNum(), ConstView<ParentPair>());
+		if (plotter != nullptr)
+			plotter->submit(bestFitness, worstFitness, avgFitness, bestCoefficients);
+	}
+	popFitnesses.clear();
+
+
+	for (int g = 1; g <= config.maxGeneration && !isStopped; g++)
+	{
+		phaseStart = std::chrono::steady_clock::now();
+
+		// Create mating pool for crossovering individuals
+		//std::vector<Curve*> matingPool = createMatingPool(*pop);
+
+		// Calculate sum of all fitnesses of the current population
+		double fitnessSum = 0;
+		for (int f = 0; f < pop->getPopulationSize(); f++)
+			fitnessSum += pop->getCurveAt(f)->getFitness();
+		int childNum = ChooseChildNum(config, runControl, evaluations, g);
+
+		// Create vector of new generation
+		std::vector<Curve*> *newGenSet;
+		std::vector<Curve*> firstParents, secondParents;
+		std::vector<ParentPair> parentPairs;
+		bool isPackedBreed = false;
+
+		if (executor != nullptr)
+		{
+			// Children are bred on this thread while the workers evaluate the ones before them
+			newGenSet = new std::vector<Curve*>();
+			evaluated = executor->breedGeneration(*pop, childNum, *newGenSet, parentPairs, runControl);
+		}
+		else if (config.useBitmaskOperators)
+		{
+			// Parents of the whole generation are chosen first and all children are bred in one pass
+			std::vector<ParentPair> pairs = chooseParentPairs(*pop, childNum);
+			newGenSet = operators->breed(*pop, pairs, config.mutationRate);
+			for (unsigned int i = 0; i < pairs.size(); i++)
+			{
+				firstParents.push_back(pop->getCurveAt(pairs[i].first));
+				secondParents.push_back(pop->getCurveAt(pairs[i].second));
+			}
+			parentPairs = pairs;
+			isPackedBreed = true;
+		}
+		else
+		{
+			newGenSet = new std::vector<Curve*>();
+
+			// crossover 200 new individuals by randomly picking two parents from the pool
+			for (int i = 0; i < childNum; i++)
+			{
+				//Curve *parent1 = matingPool.at(getRandomNumber(0, matingPool.size()-1));
+				//Curve *parent2 = matingPool.at(getRandomNumber(0, matingPool.size()-1));
+				int parentIdx1 = ChooseParentIndex(*pop, fitnessSum);
+				int parentIdx2 = ChooseParentIndex(*pop, fitnessSum);
+				Curve *parent1 = pop->getCurveAt(parentIdx1);
+				Curve *parent2 = pop->getCurveAt(parentIdx2);
+
+				//Curve *child = crossoverParents(*parent1, *parent2, config.crossoverProportion);
+				Curve *child = crossoverParents(*parent1, *parent2, config.crossoverProportion);
+
+				// Mutate child
+				if (getRandomNumber(0.0, 1.0) < config.mutationRate)
+					for (int j = 0; j < child->getDegree() + 1; j++)
+					{
+						//std::cout << "mutate child's gene #" << j << "\n";
+						//child->getCoefficientAt(j)->mutateCoefficient(mutationBits);
+						child->getCoefficientAt(j)->mutateCoefficient();
+					}
+
+				// Push the new induvidual to new generation vector
+				newGenSet->push_back(child);
+				firstParents.push_back(parent1);
+				secondParents.push_back(parent2);
+
+				// Parent indices are only needed by the history log
+				if (history != nullptr)
+					parentPairs.push_back(ParentPair{ parentIdx1, parentIdx2 });
+			}
+		}
+
+		// Children which can not beat the worst survivor are rejected early and replaced by the fitter parent
+		if (metrics != nullptr && executor == nullptr)
+		{
+			metrics->addPhaseTime(BreedingPhase, std::chrono::steady_clock::now() - phaseStart);
+			phaseStart = std::chrono::steady_clock::now();
+		}
+		// The executor tests its children on every point, the cutoff as many points as it takes to reject a child
+		if (executor == nullptr)
+			evaluated = 0;
+		pointsTested = executor != nullptr ? evaluated * pointNum : 0;
+		if (config.useFitnessCutoff)
+			for (unsigned int i = 0; i < newGenSet->size() && !runControl.shouldStop(); i++, evaluated++)
+			{
+				Curve *child = newGenSet->at(i);
+				CutoffFitness result = calculateFitnessWithCutoff(*child, *ppos, *pneg, worstFitness.back());
+				pointsTested += result.testedPoints;
+				if (result.isBelowCutoff)
+				{
+					delete child;
+					Curve *parent1 = firstParents.at(i);
+					Curve *parent2 = secondParents.at(i);
+					newGenSet->at(i) = copyCurve(parent1->getFitness() > parent2->getFitness() ? *parent1 : *parent2);
+				}
+				else
+					child->setFitness(result.fitness);
+			}
+
+		// Create new Population set using vector of new generation individuals
+		int generationNum = pop->getGenerationNum() + 1;
+		delete pop;
+		pop = new Population(newGenSet, generationNum);
+		newGenSet = nullptr;
+
+		// Calculate fitness for the children
+		if (!config.useFitnessCutoff && executor == nullptr)
+			evaluated = EvaluatePopulation(config, *pop, *ppos, *pneg, diversity, runControl, pointsTested, mixedCounts);
+		evaluations += evaluated;
+		if (metrics != nullptr)
+		{
+			metrics->addEvaluations(evaluated, pointsTested);
+			metrics->addPhaseTime(EvaluationPhase, std::chrono::steady_clock::now() - phaseStart);
+			phaseStart = std::chrono::steady_clock::now();
+		}
+		for (int i = 0; i < evaluated; i++)
+		{
+			Curve *child = pop->getCurveAt(i);
+			double fitness = GetBestCandidateFitness(*child, bestfit, *ppos, *pneg);
+
+			// Push the fitness of the child to the statistical vector
+			popFitnesses.push_back(fitness);
+
+			// Save coefficients if the fitness was the best
+			if (fitness > bestfit)
+			{
+				bestGeneration = pop->getGenerationNum();
+				bestfit = fitness;
+				child->getDecimalCoefficients(bestCoefficients);
+			}
+			child = nullptr;
+		}
+
+		// A generation cut by the deadline only contributes its evaluated children to the best so far
+		if (evaluated < childNum)
+		{
+			isStopped = true;
+			break;
+		}
+
+		bestFitness.push_back(GetMaxFitness(popFitnesses));
+		worstFitness.push_back(GetMinFitness(popFitnesses));
+		avgFitness.push_back(GetAvgFitness(popFitnesses));
+		popFitnesses.clear();
+		// Children of the packed operators are logged from their words unless the cutoff replaced some of them
+		if (history != nullptr && isPackedBreed && !config.useFitnessCutoff)
+			history->appendPopulation(*pop, pop->getGenerationNum(), operators->getChildGenomes(), parentPairs);
+		else if (history != nullptr)
+			history->appendPopulation(*pop, pop->getGenerationNum(), parentPairs);
+		if (plotter != nullptr)
+			plotter->submit(bestFitness, worstFitness, avgFitness, bestCoefficients);
+		if (metrics != nullptr)
+		{
+			metrics->addGeneration(bestfit, childNum);
+			metrics->addPhaseTime(StatisticsPhase, std::chrono::steady_clock::now() - phaseStart);
+		}
+
+		// If we found the best solution possible (100%), break the loop; sampled estimates do not count
+		if (bestfit == 1.00)
+			break;
+	}
+
+	RunResult result;
+	result.bestCoefficients.assign(bestCoefficients.begin(), bestCoefficients.end());
+	result.bestFitness = bestfit;
+	result.bestGeneration = bestGeneration;
+	result.generations = std::max(0, static_cast<int>(bestFitness.size()) - 1);
+	result.bestFitnesses = bestFitness;
+	result.worstFitnesses = worstFitness;
+	result.avgFitnesses = avgFitness;
+	result.diversity = diversity;
+	result.evaluations = evaluations;
+	result.isStopped = isStopped;
+
+	// Memory deallocation, point sets belong to the caller
+	ppos = nullptr;
+	pneg = nullptr;
+	delete pop;
+	pop = nullptr;
+	delete operators;
+	operators = nullptr;
+	delete executor;
+	executor = nullptr;
+	delete history;
+	history = nullptr;
+
+	return result;
+}
+
+// Runs the engine instantiated for the configured degree, population size and gene width
+RunResult CompiledGeneticAlgorithm(const RunConfig &config, PointSet &positiveSet, PointSet &negativeSet,
+	const SolveControl &control)
+{
+	GeneticEngineConfig engineConfig{ static_cast<double>(config.minCoefficient), static_cast<double>(config.maxCoefficient),
+		config.crossoverProportion, config.mutationRate, config.maxGeneration,
+		config.seed != 0 ? config.seed : std::random_device{}(), &control };
+	GeneticEngineResult engineResult = runGeneticEngine(config.polynomialDegree, config.populationSize,
+		config.geneBits, config.fractionalBits, positiveSet, negativeSet, engineConfig);
+
+	RunResult result;
+	result.bestCoefficients = engineResult.bestCoefficients;
+	result.bestFitness = engineResult.bestFitness;
+	result.bestGeneration = engineResult.bestGeneration;
+	result.generations = engineResult.generations;
+	result.bestFitnesses = engineResult.bestFitnesses;
+	result.worstFitnesses = engineResult.worstFitnesses;
+	result.avgFitnesses = engineResult.avgFitnesses;
+	result.evaluations = engineResult.evaluations;
+	result.isStopped = engineResult.isStopped;
+	return result;
+}
+
+// Asynchronous steady state run on the pipelined executor. Generation g is the population after g times populationSize
+// evaluated children, the history log records it without parents
+RunResult SteadyStateGeneticAlgorithm(const RunConfig &config, PointSet &positiveSet, PointSet &negativeSet,
+	const SolveControl &control, LivePlotter *plotter, RunMetrics *metrics)
+{
+	std::vector<double> bestFitness;
+	std::vector<double> worstFitness;
+	std::vector<double> avgFitness;
+	std::vector<double> diversity;
+	std::vector<int> bestCoefficients(config.polynomialDegree + 1, 0);
+	int bestGeneration = 0;
+	double bestfit = 0.0;
+	long long evaluations = 0;
+	long long pointNum = positiveSet.getPointsetSize() + negativeSet.getPointsetSize();
+	long long pointsTested = 0;
+	MixedPrecisionCounts *mixedCounts = metrics != nullptr ? metrics->getMixedCounts() : nullptr;
+	std::chrono::steady_clock::time_point phaseStart = std::chrono::steady_clock::now();
+
+	Population *pop = new Population(config.populationSize, config.polynomialDegree, config.minCoefficient, config.maxCoefficient);
+	HistoryLog *history = nullptr;
+	if (!config.historyLog.empty())
+	{
+		history = new HistoryLog();
+		if (!history->open(config.historyLog, config.polynomialDegree + 1, config.maxGeneration + 1, config.populationSize))
+		{
+			delete history;
+			history = nullptr;
+		}
+	}
+
+	int evaluated = EvaluatePopulation(config, *pop, positiveSet, negativeSet, diversity, control, pointsTested, mixedCounts);
+	evaluations += evaluated;
+	if (metrics != nullptr)
+		metrics->addEvaluations(evaluated, pointsTested);
+	bool isStopped = evaluated < pop->getPopulationSize();
+	PipelinedExecutor *executor = new PipelinedExecutor(config, positiveSet, negativeSet, mixedCounts);
+
+	for (int g = 0; g <= config.maxGeneration; g++)
+	{
+		if (g > 0 && !isStopped)
+		{
+			int received = executor->evaluateSteadyState(*pop, config.populationSize, control);
+			evaluations += received;
+			isStopped = received < config.populationSize;
+			if (metrics != nullptr)
+				metrics->addEvaluations(received, received * pointNum);
+		}
+		if (metrics != nullptr)
+		{
+			metrics->addPhaseTime(EvaluationPhase, std::chrono::steady_clock::now() - phaseStart);
+			phaseStart = std::chrono::steady_clock::now();
+		}
+
+		// The population always holds evaluated individuals, except the first one cut by the deadline
+		std::vector<double> popFitnesses;
+		int individualNum = g == 0 ? evaluated : pop->getPopulationSize();
+		for (int i = 0; i < individualNum; i++)
+		{
+			Curve *curve = pop->getCurveAt(i);
+			popFitnesses.push_back(curve->getFitness());
+			if (curve->getFitness() > bestfit)
+			{
+				bestGeneration = g;
+				bestfit = curve->getFitness();
+				curve->getDecimalCoefficients(bestCoefficients);
+			}
+		}
+		if (isStopped)
+			break;
+
+		bestFitness.push_back(GetMaxFitness(popFitnesses));
+		worstFitness.push_back(GetMinFitness(popFitnesses));
+		avgFitness.push_back(GetAvgFitness(popFitnesses));
+		if (history != nullptr)
+			history->appendPopulation(*pop, g, ConstView<ParentPair>());
+		if (plotter != nullptr)
+			plotter->submit(bestFitness, worstFitness, avgFitness, bestCoefficients);
+		if (metrics != nullptr)
+		{
+			// The initial population is not a bred generation, the same as in the generational loop
+			if (g > 0)
+				metrics->addGeneration(bestfit, config.populationSize);
+			metrics->addPhaseTime(StatisticsPhase, std::chrono::steady_clock::now() - phaseStart);
+			phaseStart = std::chrono::steady_clock::now();
+		}
+
+		if (bestFitness.back() == 1.00)
+			break;
+	}
+
+	RunResult result;
+	result.bestCoefficients.assign(bestCoefficients.begin(), bestCoefficients.end());
+	result.bestFitness = bestfit;
+	result.bestGeneration = bestGeneration;
+	result.generations = std::max(0, static_cast<int>(bestFitness.size()) - 1);
+	result.bestFitnesses = bestFitness;
+	result.worstFitnesses = worstFitness;
+	result.avgFitnesses = avgFitness;
+	result.evaluations = evaluations;
+	result.isStopped = isStopped;
+
+	// The executor goes first, it owns the children still in flight
+	delete executor;
+	executor = nullptr;
+	delete pop;
+	pop = nullptr;
+	delete history;
+	history = nullptr;
+	return result;
+}
+
+// The pipeline evaluates with plain calculateFitness, other evaluators keep the sequential loop
+bool UsePipeline(const RunConfig &config)
+{
+	return config.pipelineThreads > 0 && !config.useSampledFitness && !config.useFitnessCutoff && !config.collectClassificationBits;
+}
+
+// Calculates fitness of every individual, either exactly or by racing on point subsamples.
+// With classification bits the fitness is a popcount and behavioural diversity of generation is recorded
+// Evaluates individuals in order until the control stops the run, returns the number of evaluated ones.
+// Sampled fitness races the whole population at once, so it is only checked before it starts.
+// pointsTested gets the number of points the individuals were tested on, mixed precision points are added to mixedCounts
+int EvaluatePopulation(const RunConfig &config, Population &pop, PointSet &ppos, PointSet &pneg, std::vector<double> &diversity,
+	const SolveControl &control, long long &pointsTested, MixedPrecisionCounts *mixedCounts)
+{
+	long long pointNum = ppos.getPointsetSize() + pneg.getPointsetSize();
+	pointsTested = 0;
+	if (config.useSampledFitness)
+	{
+		if (control.shouldStop())
+			return 0;
+		pointsTested = calculateSampledFitness(pop, ppos, pneg, config.fitnessSampleSize, config.fullFitnessEvaluations,
+			config.fitnessConfidence);
+		return pop.getPopulationSize();
+	}
+
+	if (config.collectClassificationBits)
+	{
+		std::vector<ClassificationBits*> results;
+		for (int i = 0; i < pop.getPopulationSize() && !control.shouldStop(); i++)
+		{
+			results.push_back(new ClassificationBits(*pop.getCurveAt(i), ppos, pneg));
+			pop.getCurveAt(i)->setFitness(results.back()->getFitness());
+		}
+		if (static_cast<int>(results.size()) == pop.getPopulationSize())
+			diversity.push_back(calculateBehaviouralDiversity(results));
+
+		for (unsigned int i = 0; i < results.size(); i++)
+			delete results.at(i);
+		pointsTested = static_cast<long long>(results.size()) * pointNum;
+		return static_cast<int>(results.size());
+	}
+
+	// Mixed precision gives the same fitness as the double loop
+	int evaluated = 0;
+	for (; evaluated < pop.getPopulationSize() && !control.shouldStop(); evaluated++)
+	{
+		Curve &curve = *pop.getCurveAt(evaluated);
+		curve.setFitness(config.useMixedPrecision ? calculateMixedFitness(curve, ppos, pneg, mixedCounts) :
+			calculateFitness(curve, ppos, pneg));
+	}
+	pointsTested = evaluated * pointNum;
+	return evaluated;
+}
+
+// Number of children of the next generation. Without a deadline it is the configured population size,
+// under a deadline the population shrinks so that the remaining generations fit the remaining time
+// at the speed measured so far
+int ChooseChildNum(const RunConfig &config, const SolveControl &control, long long evaluations, int generation)
+{
+	if (!control.hasDeadline() || evaluations == 0)
+		return config.populationSize;
+
+	double secondsPerEvaluation = control.getElapsedSeconds() / evaluations;
+	int remainingGenerations = config.maxGeneration - generation + 1;
+	double affordable = control.getRemainingSeconds() / (secondsPerEvaluation * remainingGenerations);
+
+	int minPopulationSize = std::min(config.minPopulationSize, config.populationSize);
+	return static_cast<int>(std::max(static_cast<double>(minPopulationSize),
+		std::min(affordable, static_cast<double>(config.populationSize))));
+}
+
+double GetMaxFitness(std::vector<double> &fitnesses)
+{
+	double maxFitness = 0.0;
+	for (unsigned int i = 0; i < fitnesses.size(); i++)
+		if (fitnesses.at(i) > maxFitness)
+			maxFitness = fitnesses.at(i);
+	return maxFitness;
+}
+
+double GetMinFitness(std::vector<double> &fitnesses)
+{
+	double minFitness = 100.0;
+	for (unsigned int i = 0; i < fitnesses.size(); i++)
+		if (fitnesses.at(i) < minFitness)
+			minFitness = fitnesses.at(i);
+	return minFitness;
+}
+
+double GetAvgFitness(std::vector<double> &fitnesses)
+{
+	double sumFitness = 0.0;
+	for (unsigned int i = 0; i < fitnesses.size(); i++)
+		sumFitness += fitnesses.at(i);
+	return sumFitness / fitnesses.size();
+}
+
+Curve* ChooseParent(Population &pop, double fitnessSum)
+{
+	return pop.getCurveAt(ChooseParentIndex(pop, fitnessSum));
+}
+
+int ChooseParentIndex(Population &pop, double fitnessSum)
+{
+	double randomNum = getRandomNumber(0.0, fitnessSum);
+	double tempSum = 0;
+	for (int i = 0; i < pop.getPopulationSize(); i++)
+	{
+		if (tempSum >= randomNum)
+			return i;
+		tempSum += pop.getCurveAt(i)->getFitness();
+	}
+	return pop.getPopulationSize() - 1;
+	
+}
+
+// Fitness of the curve for best tracking. A sampled estimate that would beat the best so far is replaced
+// by the exact fitness, so the best curve and the early stop only rely on exact values
+double GetBestCandidateFitness(Curve &curve, double bestfit, const PointSet &ppos, const PointSet &pneg)
+{
+	if (!curve.isFitnessExact() && curve.getFitness() > bestfit)
+		curve.setFitness(calculateFitness(curve, ppos, pneg));
+	return curve.getFitness();
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "stdafx.h"
+#include "PointSet.h"
+#include "Curve.h"
+#include "Population.h"
+#include "RunConfig.h"
+#include "SolveControl.h"
+#include <vector>
+
+class LivePlotter;
+class RunMetrics;
+
+// Outcome of one genetic algorithm run together with per generation statistics
+struct RunResult
+{
+	std::vector<double> bestCoefficients;
+	double bestFitness;
+	int bestGeneration;
+	int generations;
+	std::vector<double> bestFitnesses;
+	std::vector<double> worstFitnesses;
+	std::vector<double> avgFitnesses;
+	std::vector<double> diversity;
+	long long evaluations = 0;
+	bool isStopped = false;
+};
+
+// Runs the genetic algorithm for the given config on the caller's point sets. The point sets are only read,
+// except that the cutoff mode with hardestPointsFirst reorders them.
+// Anytime mode: with config.timeBudget or a control the run checks its deadline and cancellation before
+// every fitness evaluation and returns the best curve found so far (isStopped is set). Under a deadline the
+// population shrinks, down to config.minPopulationSize, so that the remaining generations fit the budget.
+// Optional metrics are updated after every phase of a generation (not by the compiled engine)
+RunResult GeneticAlgorithm(const RunConfig &config, PointSet &positiveSet, PointSet &negativeSet,
+	const SolveControl *control = nullptr, LivePlotter *plotter = nullptr, RunMetrics *metrics = nullptr);
+
+// Roulette wheel selection of parent, probability is proportional to fitness
+Curve* ChooseParent(Population &pop, double fitnessSum);
+
+// Index of the parent ChooseParent would return, for callers which record parents
+int ChooseParentIndex(Population &pop, double fitnessSum);
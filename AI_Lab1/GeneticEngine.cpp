@@ -0,0 +1,66 @@
+#include "stdafx.h"
+#include "GeneticEngine.h"
+
+// Selects the engine instantiation by degree of polynomial
+template <int PopSize, int GeneBits, int FracBits>
+GeneticEngineResult runForDegree(int degree, const PointSet &positiveSet, const PointSet &negativeSet, const GeneticEngineConfig &config)
+{
+	switch (degree)
+	{
+		case 1:
+			return GeneticEngine<1, PopSize, GeneBits, FracBits>(positiveSet, negativeSet, config).run();
+		case 2:
+			return GeneticEngine<2, PopSize, GeneBits, FracBits>(positiveSet, negativeSet, config).run();
+		case 3:
+			return GeneticEngine<3, PopSize, GeneBits, FracBits>(positiveSet, negativeSet, config).run();
+		case 4:
+			return GeneticEngine<4, PopSize, GeneBits, FracBits>(positiveSet, negativeSet, config).run();
+		case 5:
+			return GeneticEngine<5, PopSize, GeneBits, FracBits>(positiveSet, negativeSet, config).run();
+		default:
+			std::cout << "Compile-time engine does not support degree " << degree << '\n';
+			return GeneticEngineResult{ {}, 0.0, 0, 0, {}, {}, {}, 0, false };
+	}
+}
+
+// Selects the engine instantiation by gene width and fixed-point fraction
+template <int PopSize>
+GeneticEngineResult runForGene(int degree, int geneBits, int fractionalBits,
+	const PointSet &positiveSet, const PointSet &negativeSet, const GeneticEngineConfig &config)
+{
+	if (geneBits == 8 && fractionalBits == 0)
+		return runForDegree<PopSize, 8, 0>(degree, positiveSet, negativeSet, config);
+	if (geneBits == 16 && fractionalBits == 0)
+		return runForDegree<PopSize, 16, 0>(degree, positiveSet, negativeSet, config);
+	if (geneBits == 16 && fractionalBits == 4)
+		return runForDegree<PopSize, 16, 4>(degree, positiveSet, negativeSet, config);
+	if (geneBits == 16 && fractionalBits == 8)
+		return runForDegree<PopSize, 16, 8>(degree, positiveSet, negativeSet, config);
+	if (geneBits == 32 && fractionalBits == 0)
+		return runForDegree<PopSize, 32, 0>(degree, positiveSet, negativeSet, config);
+	if (geneBits == 32 && fractionalBits == 4)
+		return runForDegree<PopSize, 32, 4>(degree, positiveSet, negativeSet, config);
+	if (geneBits == 32 && fractionalBits == 8)
+		return runForDegree<PopSize, 32, 8>(degree, positiveSet, negativeSet, config);
+
+	std::cout << "Compile-time engine does not support " << geneBits << "-bit genes with "
+		<< fractionalBits << " fractional bits\n";
+	return GeneticEngineResult{ {}, 0.0, 0, 0, {}, {}, {}, 0, false };
+}
+
+GeneticEngineResult runGeneticEngine(int degree, int populationSize, int geneBits, int fractionalBits,
+	const PointSet &positiveSet, const PointSet &negativeSet, const GeneticEngineConfig &config)
+{
+	switch (populationSize)
+	{
+		case 30:
+			return runForGene<30>(degree, geneBits, fractionalBits, positiveSet, negativeSet, config);
+		case 100:
+			return runForGene<100>(degree, geneBits, fractionalBits, positiveSet, negativeSet, config);
+		case 200:
+			return runForGene<200>(degree, geneBits, fractionalBits, positiveSet, negativeSet, config);
+		default:
+			std::cout << "Compile-time engine does not support population of " << populationSize << '\n';
+			return GeneticEngineResult{ {}, 0.0, 0, 0, {}, {}, {}, 0, false };
+	}
+}
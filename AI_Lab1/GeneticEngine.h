@@ -0,0 +1,305 @@
+#pragma once
+#include "stdafx.h"
+#include "Point.h"
+#include "PointSet.h"
+#include "SolveControl.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+
+// Storage type of one gene for the given gene width
+template <int GeneBits> struct GeneStorage;
+template <> struct GeneStorage<8> { typedef int8_t type; typedef uint8_t word; };
+template <> struct GeneStorage<16> { typedef int16_t type; typedef uint16_t word; };
+template <> struct GeneStorage<32> { typedef int32_t type; typedef uint32_t word; };
+
+// Horner evaluation of polynomial with compile-time degree, first coefficient belongs to the highest power
+template <int Degree>
+struct Horner
+{
+	static double evaluate(const double *coefficients, double x)
+	{
+		return Horner<Degree - 1>::evaluate(coefficients, x) * x + coefficients[Degree];
+	}
+};
+
+template <>
+struct Horner<0>
+{
+	static double evaluate(const double *coefficients, double)
+	{
+		return coefficients[0];
+	}
+};
+
+// Run parameters which stay runtime values in the compile-time configured engine
+struct GeneticEngineConfig
+{
+	double minCoefficient;
+	double maxCoefficient;
+	double crossoverProportion;
+	double mutationRate;
+	int maxGeneration;
+	unsigned int seed;
+	const SolveControl *control;
+};
+
+// Outcome of the engine run, coefficients are decoded to real values
+struct GeneticEngineResult
+{
+	std::vector<double> bestCoefficients;
+	double bestFitness;
+	int bestGeneration;
+	int generations;
+	std::vector<double> bestFitnesses;
+	std::vector<double> worstFitnesses;
+	std::vector<double> avgFitnesses;
+	long long evaluations;
+	bool isStopped;
+};
+
+// Genetic algorithm with degree, population size and gene width fixed at compile time.
+// Chromosomes are std::arrays of 8, 16 or 32 bit two's complement genes with FracBits fractional bits
+// (fixed-point coefficients), so all per-gene loops have constant trip counts and the fitness kernel
+// is specialized for the degree
+template <int Degree, int PopSize, int GeneBits, int FracBits = 0>
+class GeneticEngine
+{
+	static_assert(Degree >= 1, "Degree of polynomial should be positive");
+	static_assert(PopSize >= 2, "Population should contain at least two individuals");
+	static_assert(FracBits >= 0 && FracBits < GeneBits - 1, "Fractional bits should leave room for sign and integer part");
+
+public:
+	static constexpr int geneNum = Degree + 1;
+	typedef typename GeneStorage<GeneBits>::type Gene;
+	typedef typename GeneStorage<GeneBits>::word GeneWord;
+	typedef std::array<Gene, geneNum> Chromosome;
+
+private:
+	std::array<Chromosome, PopSize> m_population;
+	std::array<double, PopSize> m_fitness;
+	std::vector<double> m_x;
+	std::vector<double> m_y;
+	int m_positiveNum;
+	GeneticEngineConfig m_config;
+	std::mt19937 m_mersenne;
+
+	// Smallest and largest gene of the configured coefficient range that fit the gene width
+	long long getGeneMin()
+	{
+		double scale = static_cast<double>(1 << FracBits);
+		return static_cast<long long>(std::max(m_config.minCoefficient * scale, static_cast<double>(std::numeric_limits<Gene>::min())));
+	}
+
+	long long getGeneMax()
+	{
+		double scale = static_cast<double>(1 << FracBits);
+		return static_cast<long long>(std::min(m_config.maxCoefficient * scale, static_cast<double>(std::numeric_limits<Gene>::max())));
+	}
+
+	// Random gene in the configured coefficient range, leading coefficient can not be zero
+	Gene randomGene(bool canBeZero)
+	{
+		std::uniform_int_distribution<long long> distribution(getGeneMin(), getGeneMax());
+		Gene gene;
+		do
+		{
+			gene = static_cast<Gene>(distribution(m_mersenne));
+		} while (gene == 0 && !canBeZero);
+		return gene;
+	}
+
+	double randomUnit()
+	{
+		return std::uniform_real_distribution<double>(0.0, 1.0)(m_mersenne);
+	}
+
+	// Roulette wheel selection, the same rule as ChooseParent
+	int chooseParent(double fitnessSum)
+	{
+		double randomNum = randomUnit() * fitnessSum;
+		double tempSum = 0;
+		for (int i = 0; i < PopSize; i++)
+		{
+			if (tempSum >= randomNum)
+				return i;
+			tempSum += m_fitness[i];
+		}
+		return PopSize - 1;
+	}
+
+	// Every bit of the gene's offset from the smallest gene flips with probability 1/4 (the AND of two random
+	// words), bitMutationProbability of Coefficient::mutateCoefficient and the packed operators, so a mutated
+	// child changes about a quarter of its bits as in the runtime algorithm. Only the bits spanning the coefficient
+	// range are flipped; a gene which would leave the range, or a leading coefficient which would become zero,
+	// keeps its value, as in the packed gray and offset codecs. The effective rate is therefore slightly lower
+	// for genes near the ends of the range
+	void mutate(Chromosome &chromosome)
+	{
+		long long lo = getGeneMin();
+		unsigned long long range = static_cast<unsigned long long>(getGeneMax() - lo);
+		unsigned long long bits = 1;
+		while (bits <= range && bits < (1ull << 62))
+			bits <<= 1;
+		for (int j = 0; j < geneNum; j++)
+		{
+			unsigned long long offset = static_cast<unsigned long long>(chromosome[j] - lo);
+			unsigned long long mask = randomWord() & randomWord() & (bits - 1);
+			unsigned long long mutated = offset ^ mask;
+			if (mutated > range || (j == 0 && lo + static_cast<long long>(mutated) == 0))
+				continue;
+			chromosome[j] = static_cast<Gene>(lo + static_cast<long long>(mutated));
+		}
+	}
+
+	unsigned long long randomWord()
+	{
+		return (static_cast<unsigned long long>(m_mersenne()) << 32) | m_mersenne();
+	}
+
+public:
+	GeneticEngine(const PointSet &positiveSet, const PointSet &negativeSet, const GeneticEngineConfig &config)
+		: m_config(config), m_mersenne(config.seed)
+	{
+		ConstView<Point> positives = positiveSet.getPoints();
+		ConstView<Point> negatives = negativeSet.getPoints();
+		m_positiveNum = static_cast<int>(positives.size());
+		m_x.reserve(positives.size() + negatives.size());
+		m_y.reserve(positives.size() + negatives.size());
+
+		// Points are kept as structure of arrays, positive points first
+		for (const Point &point : positives)
+		{
+			m_x.push_back(point.getX());
+			m_y.push_back(point.getY());
+		}
+		for (const Point &point : negatives)
+		{
+			m_x.push_back(point.getX());
+			m_y.push_back(point.getY());
+		}
+	}
+
+	static double decode(Gene gene)
+	{
+		return static_cast<double>(gene) / (1 << FracBits);
+	}
+
+	static std::array<double, geneNum> decode(const Chromosome &chromosome)
+	{
+		std::array<double, geneNum> coefficients;
+		for (int j = 0; j < geneNum; j++)
+			coefficients[j] = decode(chromosome[j]);
+		return coefficients;
+	}
+
+	double calculateFitness(const Chromosome &chromosome)
+	{
+		std::array<double, geneNum> coefficients = decode(chromosome);
+		const double *x = m_x.data();
+		const double *y = m_y.data();
+		int pointNum = static_cast<int>(m_x.size());
+
+		int fitnessScore = 0;
+		for (int i = 0; i < m_positiveNum; i++)
+			fitnessScore += y[i] > Horner<Degree>::evaluate(coefficients.data(), x[i]);
+		for (int i = m_positiveNum; i < pointNum; i++)
+			fitnessScore += !(y[i] > Horner<Degree>::evaluate(coefficients.data(), x[i]));
+
+		return pointNum == 0 ? 0.0 : (double)fitnessScore / pointNum;
+	}
+
+	GeneticEngineResult run()
+	{
+		GeneticEngineResult result;
+		result.bestFitness = 0.0;
+		result.bestGeneration = 0;
+		result.generations = 0;
+		result.evaluations = 0;
+		result.isStopped = false;
+		Chromosome best = Chromosome();
+
+		for (int i = 0; i < PopSize; i++)
+		{
+			m_population[i][0] = randomGene(false);
+			for (int j = 1; j < geneNum; j++)
+				m_population[i][j] = randomGene(true);
+		}
+
+		int crossoverPoint = static_cast<int>(floor(geneNum * m_config.crossoverProportion));
+		std::array<Chromosome, PopSize> offspring;
+
+		for (int g = 0; g <= m_config.maxGeneration; g++)
+		{
+			// Breed a new generation from the evaluated previous one
+			if (g > 0)
+			{
+				double fitnessSum = 0;
+				for (int i = 0; i < PopSize; i++)
+					fitnessSum += m_fitness[i];
+
+				for (int i = 0; i < PopSize; i++)
+				{
+					const Chromosome &parent1 = m_population[chooseParent(fitnessSum)];
+					const Chromosome &parent2 = m_population[chooseParent(fitnessSum)];
+					for (int j = 0; j < geneNum; j++)
+						offspring[i][j] = j < crossoverPoint ? parent1[j] : parent2[j];
+
+					if (randomUnit() < m_config.mutationRate)
+						mutate(offspring[i]);
+				}
+				m_population = offspring;
+			}
+
+			double maxFitness = 0.0, minFitness = 1.0, sumFitness = 0.0;
+			for (int i = 0; i < PopSize; i++)
+			{
+				// Anytime mode: a generation cut by the deadline only contributes to the best so far
+				if (m_config.control != nullptr && m_config.control->shouldStop())
+				{
+					result.isStopped = true;
+					break;
+				}
+
+				m_fitness[i] = calculateFitness(m_population[i]);
+				result.evaluations++;
+				maxFitness = std::max(maxFitness, m_fitness[i]);
+				minFitness = std::min(minFitness, m_fitness[i]);
+				sumFitness += m_fitness[i];
+
+				if (m_fitness[i] > result.bestFitness)
+				{
+					result.bestFitness = m_fitness[i];
+					result.bestGeneration = g;
+					best = m_population[i];
+				}
+			}
+
+			if (result.isStopped)
+				break;
+
+			result.bestFitnesses.push_back(maxFitness);
+			result.worstFitnesses.push_back(minFitness);
+			result.avgFitnesses.push_back(sumFitness / PopSize);
+			result.generations = g;
+
+			if (maxFitness == 1.00)
+				break;
+		}
+
+		std::array<double, geneNum> coefficients = decode(best);
+		result.bestCoefficients.assign(coefficients.begin(), coefficients.end());
+		return result;
+	}
+};
+
+// Runs the compile-time configured engine matching the runtime parameters. Covers degree 1-5,
+// populations of 30, 100 and 200, 8/16/32-bit integer genes and 16/32-bit genes with 4 or 8 fractional bits.
+// Unsupported configurations return an empty result
+GeneticEngineResult runGeneticEngine(int degree, int populationSize, int geneBits, int fractionalBits,
+	const PointSet &positiveSet, const PointSet &negativeSet, const GeneticEngineConfig &config);
@@ -2,38 +2,56 @@
 #define GNUPLOT_H_
 #include <string>
 #include <iostream>
+#include <cstdio>
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
 
 using namespace std;
 
 class Gnuplot
 {
 public:
-	Gnuplot();
+	Gnuplot(const string & path);
 	~Gnuplot();
 	void operator ()(const string & command);
-	// send any command to gnuplot
+	// send any command to gnuplot, commands are buffered until flush
+	void flush();
+	bool isOpen();
 protected:
 	FILE * gnuplotpipe;
-	const char *path = "\"C:\\gnuplot\\bin\\gnuplot.exe -persist\"";
 };
 
-Gnuplot::Gnuplot() {
+inline Gnuplot::Gnuplot(const string & path) {
 	// with -persist option you will see the windows as your program ends
-	//gnuplotpipe=_popen("gnuplot -persist","w");
+	//gnuplotpipe=popen("gnuplot -persist","w");
 	//without that option you will not see the window
-	// because I choose the terminal to output files so I don't want to see the window
-	gnuplotpipe = _popen(path, "w");
+	gnuplotpipe = popen(path.c_str(), "w");
 	if (!gnuplotpipe) {
 		cerr << ("Gnuplot not found !");
 	}
 }
-Gnuplot::~Gnuplot() {
+inline Gnuplot::~Gnuplot() {
+	if (!gnuplotpipe)
+		return;
 	fprintf(gnuplotpipe, "exit\n");
-	_pclose(gnuplotpipe);
+	pclose(gnuplotpipe);
 }
-void Gnuplot::operator()(const string & command) {
-	fprintf(gnuplotpipe, "%s\n", command.c_str());
-	fflush(gnuplotpipe);
+inline void Gnuplot::operator()(const string & command) {
+	if (gnuplotpipe && fprintf(gnuplotpipe, "%s\n", command.c_str()) < 0) {
+		pclose(gnuplotpipe);
+		gnuplotpipe = nullptr;
+	}
+}
+inline void Gnuplot::flush() {
 	// flush is necessary, nothing gets plotted else
-};
-#endif
\ No newline at end of file
+	if (gnuplotpipe && fflush(gnuplotpipe) != 0) {
+		pclose(gnuplotpipe);
+		gnuplotpipe = nullptr;
+	}
+}
+inline bool Gnuplot::isOpen() {
+	return gnuplotpipe != nullptr;
+}
+#endif
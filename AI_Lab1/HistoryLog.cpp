@@ -0,0 +1,300 @@
+#include "stdafx.h"
+#include "HistoryLog.h"
+#include <atomic>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const char historyMagic[8] = { 'G', 'A', 'H', 'I', 'S', 'T', '0', '1' };
+
+// Bytes of one generation block with the given number of individuals
+uint64_t getBlockSize(int wordNum, int individualNum)
+{
+	return static_cast<uint64_t>(individualNum) * (wordNum * sizeof(uint64_t) + sizeof(double) + sizeof(ParentPair));
+}
+
+HistoryLog::HistoryLog() : m_fd(-1), m_map(nullptr), m_header(nullptr), m_index(nullptr)
+{
+
+}
+
+HistoryLog::~HistoryLog()
+{
+	close();
+}
+
+// Creates the file and maps the whole capacity, on Linux the unused part stays sparse
+bool HistoryLog::open(const std::string &filename, int geneNum, int generationCapacity, int maxIndividualNum)
+{
+#ifndef _WIN32
+	close();
+	int wordNum = (geneNum + 7) / 8;
+	uint64_t dataOffset = sizeof(HistoryHeader) + static_cast<uint64_t>(generationCapacity) * sizeof(HistoryIndexEntry);
+	uint64_t fileSize = dataOffset + getBlockSize(wordNum, maxIndividualNum) * generationCapacity;
+
+	m_fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (m_fd < 0 || ftruncate(m_fd, static_cast<off_t>(fileSize)) != 0)
+	{
+		std::cerr << "Cannot create history log " << filename << std::endl;
+		close();
+		return false;
+	}
+
+	void *map = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+	if (map == MAP_FAILED)
+	{
+		std::cerr << "Cannot map history log " << filename << std::endl;
+		close();
+		return false;
+	}
+
+	m_map = static_cast<unsigned char*>(map);
+	m_header = reinterpret_cast<HistoryHeader*>(m_map);
+	m_index = reinterpret_cast<HistoryIndexEntry*>(m_map + sizeof(HistoryHeader));
+	memcpy(m_header->magic, historyMagic, sizeof(historyMagic));
+	m_header->geneNum = geneNum;
+	m_header->wordNum = wordNum;
+	m_header->generationCapacity = generationCapacity;
+	m_header->generationNum = 0;
+	m_header->dataOffset = dataOffset;
+	m_header->dataEnd = dataOffset;
+	m_header->fileSize = fileSize;
+	return true;
+#else
+	std::cerr << "History log requires POSIX memory mapping" << std::endl;
+	return false;
+#endif
+}
+
+bool HistoryLog::isOpen()
+{
+	return m_map != nullptr;
+}
+
+bool HistoryLog::appendGeneration(int generation, ConstView<uint64_t> genomes, ConstView<double> fitness, ConstView<ParentPair> parents)
+{
+	if (m_map == nullptr || m_header->generationNum >= m_header->generationCapacity)
+		return false;
+
+	int individualNum = static_cast<int>(fitness.size());
+	uint64_t blockSize = getBlockSize(m_header->wordNum, individualNum);
+	if (m_header->dataEnd + blockSize > m_header->fileSize)
+		return false;
+
+	unsigned char *block = m_map + m_header->dataEnd;
+	memcpy(block, genomes.data(), genomes.size() * sizeof(uint64_t));
+	block += static_cast<size_t>(individualNum) * m_header->wordNum * sizeof(uint64_t);
+	memcpy(block, fitness.data(), fitness.size() * sizeof(double));
+	block += static_cast<size_t>(individualNum) * sizeof(double);
+	memcpy(block, parents.data(), parents.size() * sizeof(ParentPair));
+
+	// The index entry and counters are published after the block
+	std::atomic_thread_fence(std::memory_order_release);
+	HistoryIndexEntry &entry = m_index[m_header->generationNum];
+	entry.offset = m_header->dataEnd;
+	entry.generation = generation;
+	entry.individualNum = individualNum;
+	m_header->dataEnd += blockSize;
+	m_header->generationNum++;
+	return true;
+}
+
+// Packs the genomes and fitnesses of the population into reused buffers and appends them
+bool HistoryLog::appendPopulation(Population &population, int generation, ConstView<ParentPair> parents)
+{
+	if (m_map == nullptr)
+		return false;
+
+	int individualNum = population.getPopulationSize();
+	int geneNum = m_header->geneNum;
+	int wordNum = m_header->wordNum;
+	m_genomes.assign(static_cast<size_t>(individualNum) * wordNum, 0);
+	m_fitness.resize(individualNum);
+	m_parents.assign(individualNum, ParentPair{ -1, -1 });
+
+	for (int i = 0; i < individualNum; i++)
+	{
+		Curve *curve = population.getCurveAt(i);
+		ConstView<const Coefficient*> coefficients = curve->getCoefficients();
+		uint64_t *words = &m_genomes[static_cast<size_t>(i) * wordNum];
+		for (int j = 0; j < geneNum && j < static_cast<int>(coefficients.size()); j++)
+			words[j / 8] |= static_cast<uint64_t>(static_cast<uint8_t>(coefficients[j]->getNumber())) << (8 * (j % 8));
+		m_fitness[i] = curve->getFitness();
+		if (i < static_cast<int>(parents.size()))
+			m_parents[i] = parents[i];
+	}
+
+	return appendGeneration(generation, m_genomes, m_fitness, m_parents);
+}
+
+// Appends genomes already packed in the log layout, only fitnesses are gathered from the population
+bool HistoryLog::appendPopulation(Population &population, int generation, ConstView<uint64_t> genomes,
+	ConstView<ParentPair> parents)
+{
+	int individualNum = population.getPopulationSize();
+	if (m_map == nullptr || genomes.size() != static_cast<size_t>(individualNum) * m_header->wordNum ||
+		parents.size() != static_cast<size_t>(individualNum))
+		return false;
+
+	m_fitness.resize(individualNum);
+	for (int i = 0; i < individualNum; i++)
+		m_fitness[i] = population.getCurveAt(i)->getFitness();
+	return appendGeneration(generation, genomes, m_fitness, parents);
+}
+
+// Unmaps the file and cuts it to the used size
+void HistoryLog::close()
+{
+#ifndef _WIN32
+	if (m_map != nullptr)
+	{
+		uint64_t fileSize = m_header->fileSize;
+		uint64_t dataEnd = m_header->dataEnd;
+		m_header->fileSize = dataEnd;
+		msync(m_map, fileSize, MS_SYNC);
+		munmap(m_map, fileSize);
+		if (ftruncate(m_fd, static_cast<off_t>(dataEnd)) != 0)
+			std::cerr << "Cannot shrink history log" << std::endl;
+	}
+	if (m_fd >= 0)
+		::close(m_fd);
+#endif
+	m_fd = -1;
+	m_map = nullptr;
+	m_header = nullptr;
+	m_index = nullptr;
+}
+
+HistoryReader::HistoryReader() : m_fd(-1), m_map(nullptr), m_header(nullptr), m_index(nullptr), m_size(0)
+{
+
+}
+
+HistoryReader::~HistoryReader()
+{
+	close();
+}
+
+bool HistoryReader::open(const std::string &filename)
+{
+#ifndef _WIN32
+	close();
+	struct stat info;
+	m_fd = ::open(filename.c_str(), O_RDONLY);
+	if (m_fd < 0 || fstat(m_fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(HistoryHeader))
+	{
+		std::cerr << "Cannot open history log " << filename << std::endl;
+		close();
+		return false;
+	}
+
+	m_size = static_cast<size_t>(info.st_size);
+	void *map = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+	if (map == MAP_FAILED)
+	{
+		std::cerr << "Cannot map history log " << filename << std::endl;
+		close();
+		return false;
+	}
+
+	m_map = static_cast<const unsigned char*>(map);
+	m_header = reinterpret_cast<const HistoryHeader*>(m_map);
+	m_index = reinterpret_cast<const HistoryIndexEntry*>(m_map + sizeof(HistoryHeader));
+	if (memcmp(m_header->magic, historyMagic, sizeof(historyMagic)) != 0 || !isValid())
+	{
+		std::cerr << filename << " is not a history log" << std::endl;
+		close();
+		return false;
+	}
+	return true;
+#else
+	std::cerr << "History log requires POSIX memory mapping" << std::endl;
+	return false;
+#endif
+}
+
+// Header, index and every generation block lie inside the mapped file, so the getters need no checks
+bool HistoryReader::isValid()
+{
+	const HistoryHeader &header = *m_header;
+	if (header.geneNum == 0 || header.wordNum != (header.geneNum + 7) / 8 || header.generationNum > header.generationCapacity)
+		return false;
+	uint64_t dataOffset = sizeof(HistoryHeader) + static_cast<uint64_t>(header.generationCapacity) * sizeof(HistoryIndexEntry);
+	if (header.dataOffset != dataOffset || dataOffset > header.dataEnd || header.dataEnd > m_size)
+		return false;
+
+	for (uint32_t idx = 0; idx < header.generationNum; idx++)
+	{
+		const HistoryIndexEntry &entry = m_index[idx];
+		if (entry.offset < dataOffset || entry.offset > header.dataEnd ||
+			getBlockSize(header.wordNum, entry.individualNum) > header.dataEnd - entry.offset)
+			return false;
+	}
+	return true;
+}
+
+int HistoryReader::getGenerationNum()
+{
+	return m_header == nullptr ? 0 : m_header->generationNum;
+}
+
+int HistoryReader::getGeneNum()
+{
+	return m_header == nullptr ? 0 : m_header->geneNum;
+}
+
+// Generation number recorded in the idx-th index entry
+int HistoryReader::getGeneration(int idx)
+{
+	return m_index[idx].generation;
+}
+
+int HistoryReader::getIndividualNum(int idx)
+{
+	return m_index[idx].individualNum;
+}
+
+std::vector<int> HistoryReader::getGenome(int idx, int individual)
+{
+	const uint64_t *words = reinterpret_cast<const uint64_t*>(m_map + m_index[idx].offset) +
+		static_cast<size_t>(individual) * m_header->wordNum;
+
+	std::vector<int> genome(m_header->geneNum);
+	for (unsigned int j = 0; j < genome.size(); j++)
+		genome[j] = static_cast<int8_t>(words[j / 8] >> (8 * (j % 8)));
+	return genome;
+}
+
+double HistoryReader::getFitness(int idx, int individual)
+{
+	const HistoryIndexEntry &entry = m_index[idx];
+	const unsigned char *fitness = m_map + entry.offset + static_cast<size_t>(entry.individualNum) * m_header->wordNum * sizeof(uint64_t);
+	return reinterpret_cast<const double*>(fitness)[individual];
+}
+
+ParentPair HistoryReader::getParents(int idx, int individual)
+{
+	const HistoryIndexEntry &entry = m_index[idx];
+	const unsigned char *parents = m_map + entry.offset +
+		static_cast<size_t>(entry.individualNum) * (m_header->wordNum * sizeof(uint64_t) + sizeof(double));
+	return reinterpret_cast<const ParentPair*>(parents)[individual];
+}
+
+void HistoryReader::close()
+{
+#ifndef _WIN32
+	if (m_map != nullptr)
+		munmap(const_cast<unsigned char*>(m_map), m_size);
+	if (m_fd >= 0)
+		::close(m_fd);
+#endif
+	m_fd = -1;
+	m_map = nullptr;
+	m_header = nullptr;
+	m_index = nullptr;
+	m_size = 0;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "stdafx.h"
+#include "ConstView.h"
+#include "GenerationOperators.h"
+#include "Population.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// File layout: header, index with one entry per generation slot, then generation blocks.
+// A block holds the packed genomes of all individuals (wordNum words each, 8-bit two's complement genes,
+// gene j in byte j % 8 of word j / 8), then their fitnesses, then their parent index pairs (-1 for the
+// first generation). Generation and data counters in the header are updated after the block is written,
+// so a reader of a file being written sees only complete generations
+struct HistoryHeader
+{
+	char magic[8];
+	uint32_t geneNum;
+	uint32_t wordNum;
+	uint32_t generationCapacity;
+	uint32_t generationNum;
+	uint64_t dataOffset;
+	uint64_t dataEnd;
+	uint64_t fileSize;
+};
+
+struct HistoryIndexEntry
+{
+	uint64_t offset;
+	uint32_t generation;
+	uint32_t individualNum;
+};
+
+// Append-only generation history in a preallocated memory-mapped file (POSIX only).
+// Appending a generation is three memcpy calls into the mapping and an index entry. Generations bred by the
+// packed operators are appended from their genomes, others are packed from the curves of the population first
+class HistoryLog
+{
+	int m_fd;
+	unsigned char *m_map;
+	HistoryHeader *m_header;
+	HistoryIndexEntry *m_index;
+	std::vector<uint64_t> m_genomes;
+	std::vector<double> m_fitness;
+	std::vector<ParentPair> m_parents;
+
+public:
+	HistoryLog();
+	bool open(const std::string &filename, int geneNum, int generationCapacity, int maxIndividualNum);
+	bool isOpen();
+	bool appendGeneration(int generation, ConstView<uint64_t> genomes, ConstView<double> fitness, ConstView<ParentPair> parents);
+	bool appendPopulation(Population &population, int generation, ConstView<ParentPair> parents);
+	bool appendPopulation(Population &population, int generation, ConstView<uint64_t> genomes, ConstView<ParentPair> parents);
+	void close();
+	~HistoryLog();
+};
+
+// Read-only view of a history file, every generation and individual is found through the index in O(1).
+// The header and every index entry are checked against the file size when it is opened
+class HistoryReader
+{
+	int m_fd;
+	const unsigned char *m_map;
+	const HistoryHeader *m_header;
+	const HistoryIndexEntry *m_index;
+	size_t m_size;
+
+	bool isValid();
+
+public:
+	HistoryReader();
+	bool open(const std::string &filename);
+	int getGenerationNum();
+	int getGeneNum();
+	int getGeneration(int idx);
+	int getIndividualNum(int idx);
+	std::vector<int> getGenome(int idx, int individual);
+	double getFitness(int idx, int individual);
+	ParentPair getParents(int idx, int individual);
+	void close();
+	~HistoryReader();
+};
@@ -0,0 +1,228 @@
+#include "stdafx.h"
+#include "LivePlotter.h"
+#include "Gnuplot.h"
+#include <fstream>
+#include <sstream>
+
+LivePlotter::LivePlotter(const RunConfig &config, ConstView<Point> positivePoints, ConstView<Point> negativePoints)
+	: m_terminal(config.plotTerminal), m_directory(config.plotDirectory), m_gnuplotPath(config.gnuplotPath),
+	m_pointMinX(config.pointMinX), m_pointMaxX(config.pointMaxX), m_pointMinY(config.pointMinY), m_pointMaxY(config.pointMaxY),
+	m_positivePoints(positivePoints.begin(), positivePoints.end()), m_negativePoints(negativePoints.begin(), negativePoints.end()),
+	m_isLive(config.plotRate > 0.0 && config.plotTerminal != "none"), m_hasPending(false), m_isStopping(false),
+	m_submittedFrames(0), m_droppedFrames(0), m_renderedFrames(0)
+{
+	double rate = config.plotRate > 0.0 ? config.plotRate : 1.0;
+	m_frameInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / rate));
+	m_nextFrame = std::chrono::steady_clock::now();
+
+	// Live frames need the worker from the start, a final plot only starts it in finish
+	if (isLive())
+		m_worker = std::thread(&LivePlotter::workerLoop, this);
+}
+
+LivePlotter::~LivePlotter()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStopping = true;
+	}
+	m_frameReady.notify_one();
+	if (m_worker.joinable())
+		m_worker.join();
+}
+
+bool LivePlotter::isLive()
+{
+	return m_isLive;
+}
+
+// Called by the generation loop, returns at once when no frame is due or the worker holds the frame
+void LivePlotter::submit(ConstView<double> bestFitnesses, ConstView<double> worstFitnesses, ConstView<double> avgFitnesses,
+	ConstView<int> bestCoefficients)
+{
+	if (!m_isLive || !m_worker.joinable())
+		return;
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (now < m_nextFrame)
+		return;
+	m_nextFrame = now + m_frameInterval;
+	m_submittedFrames++;
+
+	std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+	if (!lock.owns_lock())
+	{
+		m_droppedFrames++;
+		return;
+	}
+	if (m_hasPending)
+		m_droppedFrames++;
+	m_pending.bestFitnesses.assign(bestFitnesses.begin(), bestFitnesses.end());
+	m_pending.worstFitnesses.assign(worstFitnesses.begin(), worstFitnesses.end());
+	m_pending.avgFitnesses.assign(avgFitnesses.begin(), avgFitnesses.end());
+	m_pending.bestCoefficients.assign(bestCoefficients.begin(), bestCoefficients.end());
+	m_hasPending = true;
+	lock.unlock();
+	m_frameReady.notify_one();
+}
+
+// Replaces any waiting frame by the final one and waits until it is plotted
+void LivePlotter::finish(const RunResult &result)
+{
+	if (m_terminal == "none")
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pending.bestFitnesses = result.bestFitnesses;
+		m_pending.worstFitnesses = result.worstFitnesses;
+		m_pending.avgFitnesses = result.avgFitnesses;
+		m_pending.bestCoefficients = result.bestCoefficients;
+		if (m_hasPending)
+			m_droppedFrames++;
+		m_hasPending = true;
+		m_isStopping = true;
+		m_submittedFrames++;
+	}
+	if (!m_worker.joinable())
+		m_worker = std::thread(&LivePlotter::workerLoop, this);
+	m_frameReady.notify_one();
+	m_worker.join();
+}
+
+int LivePlotter::getSubmittedFrames()
+{
+	return m_submittedFrames;
+}
+
+int LivePlotter::getRenderedFrames()
+{
+	return m_renderedFrames;
+}
+
+int LivePlotter::getDroppedFrames()
+{
+	return m_droppedFrames;
+}
+
+void LivePlotter::workerLoop()
+{
+	// Interactive plots keep one window per graph, image terminals write both graphs through one process
+	Gnuplot *fitPlot = nullptr;
+	Gnuplot *curvePlot = nullptr;
+	if (m_terminal == "window")
+	{
+		fitPlot = new Gnuplot(m_gnuplotPath + " -persist");
+		curvePlot = new Gnuplot(m_gnuplotPath + " -persist");
+	}
+	else if (m_terminal == "png" || m_terminal == "svg")
+		fitPlot = new Gnuplot(m_gnuplotPath);
+
+	PlotFrame frame;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_frameReady.wait(lock, [this] { return m_hasPending || m_isStopping; });
+			if (!m_hasPending)
+				break;
+			std::swap(frame, m_pending);
+			m_hasPending = false;
+		}
+
+		if (m_terminal == "script")
+		{
+			std::ofstream fitScript(m_directory + "/FitnessPlot.gp");
+			fitScript << "set terminal png size 800,600\nset output '" << getImageName("FitnessPlot") << "'\n" << getFitnessCommands(frame);
+			std::ofstream curveScript(m_directory + "/CurvePlot.gp");
+			curveScript << "set terminal png size 800,600\nset output '" << getImageName("CurvePlot") << "'\n" << getCurveCommands(frame);
+		}
+		else if (m_terminal == "window")
+		{
+			(*fitPlot)(getFitnessCommands(frame));
+			fitPlot->flush();
+			(*curvePlot)(getCurveCommands(frame));
+			curvePlot->flush();
+		}
+		else if (fitPlot != nullptr)
+		{
+			std::string terminal = m_terminal == "svg" ? "set terminal svg size 800,600" : "set terminal png size 800,600";
+			(*fitPlot)(terminal + "\nset output '" + getImageName("FitnessPlot") + "'\n" + getFitnessCommands(frame) +
+				"reset\nset output '" + getImageName("CurvePlot") + "'\n" + getCurveCommands(frame) + "set output");
+			fitPlot->flush();
+		}
+		m_renderedFrames++;
+	}
+
+	delete fitPlot;
+	delete curvePlot;
+}
+
+// Fitness series as gnuplot data blocks and the plot of all three
+std::string LivePlotter::getFitnessCommands(const PlotFrame &frame)
+{
+	std::ostringstream out;
+	const std::vector<double> *series[] = { &frame.bestFitnesses, &frame.worstFitnesses, &frame.avgFitnesses };
+	const char *names[] = { "$best", "$worst", "$avg" };
+	for (int s = 0; s < 3; s++)
+	{
+		out << names[s] << " << EOD\n";
+		for (unsigned int i = 0; i < series[s]->size(); i++)
+			out << i << ' ' << series[s]->at(i) << '\n';
+		out << "EOD\n";
+	}
+
+	out << "set title \"Genetic Algorithm fitness values\"\n"
+		<< "set grid\n"
+		<< "set xlabel 'generation'\n"
+		<< "set ylabel 'fitness value'\n"
+		<< (frame.bestFitnesses.size() <= 30 ? "set xtics 1\n" : "set xtics autofreq\n")
+		<< "set ytics 0.1\n"
+		<< "plot [:] [0.00:1.50] $best lc rgb 'green' title 'Best Fitness' with lines, "
+		<< "$worst lc rgb 'blue' title 'Worst Fitness' with lines, $avg lc rgb 'red' title 'Average Fitness' with lines\n";
+	return out.str();
+}
+
+// Point sets as data blocks and the best curve as a polynomial in x
+std::string LivePlotter::getCurveCommands(const PlotFrame &frame)
+{
+	std::ostringstream out;
+	const std::vector<Point> *sets[] = { &m_positivePoints, &m_negativePoints };
+	const char *names[] = { "$positive", "$negative" };
+	for (int s = 0; s < 2; s++)
+	{
+		out << names[s] << " << EOD\n";
+		for (const Point &point : *sets[s])
+			out << point.getX() << ' ' << point.getY() << '\n';
+		out << "EOD\n";
+	}
+
+	out << "set title \"Best Curve\"\n"
+		<< "set grid\n"
+		<< "set xtics 1\n"
+		<< "set ytics 1\n"
+		<< "plot [" << m_pointMinX << ':' << m_pointMaxX << "] [" << m_pointMinY << ':' << m_pointMaxY << "] "
+		<< "$positive lc rgb 'red' title 'Positive Points', $negative lc rgb 'blue' title 'Negative Points'";
+
+	int coefNum = static_cast<int>(frame.bestCoefficients.size());
+	if (coefNum > 0)
+	{
+		out << ", ";
+		for (int i = 0; i < coefNum; i++)
+		{
+			int power = coefNum - 1 - i;
+			out << (i == 0 ? "(" : "+(") << frame.bestCoefficients.at(i);
+			if (power > 0)
+				out << "*x" << (power > 1 ? "**" + std::to_string(power) : "");
+			out << ")";
+		}
+		out << " lc rgb 'black' title 'Best Function'";
+	}
+	out << '\n';
+	return out.str();
+}
+
+std::string LivePlotter::getImageName(const std::string &name)
+{
+	return m_directory + "/" + name + (m_terminal == "svg" ? ".svg" : ".png");
+}
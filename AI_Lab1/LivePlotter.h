@@ -0,0 +1,64 @@
+#pragma once
+#include "stdafx.h"
+#include "ConstView.h"
+#include "GeneticAlgorithm.h"
+#include "Point.h"
+#include "RunConfig.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Fitness series and best curve of the run at one moment
+struct PlotFrame
+{
+	std::vector<double> bestFitnesses;
+	std::vector<double> worstFitnesses;
+	std::vector<double> avgFitnesses;
+	std::vector<double> bestCoefficients;
+};
+
+// Plots the run on a background thread. The generation loop only hands over a frame: at most plotRate
+// frames per second are taken, and a frame that arrives while the previous one is still waiting replaces it,
+// so a slow gnuplot drops frames instead of stalling the run. Terminals: "window" (interactive gnuplot),
+// "png" and "svg" (image files in plotDirectory), "script" (gnuplot scripts with inline data, no process)
+// and "none". Data is sent inline, so no paths to .dat files are needed
+class LivePlotter
+{
+	std::string m_terminal;
+	std::string m_directory;
+	std::string m_gnuplotPath;
+	double m_pointMinX, m_pointMaxX, m_pointMinY, m_pointMaxY;
+	std::vector<Point> m_positivePoints;
+	std::vector<Point> m_negativePoints;
+	std::chrono::steady_clock::duration m_frameInterval;
+	std::chrono::steady_clock::time_point m_nextFrame;
+	bool m_isLive;
+	PlotFrame m_pending;
+	bool m_hasPending;
+	bool m_isStopping;
+	int m_submittedFrames;
+	int m_droppedFrames;
+	int m_renderedFrames;
+	std::mutex m_mutex;
+	std::condition_variable m_frameReady;
+	std::thread m_worker;
+
+	void workerLoop();
+	std::string getFitnessCommands(const PlotFrame &frame);
+	std::string getCurveCommands(const PlotFrame &frame);
+	std::string getImageName(const std::string &name);
+
+public:
+	LivePlotter(const RunConfig &config, ConstView<Point> positivePoints, ConstView<Point> negativePoints);
+	bool isLive();
+	void submit(ConstView<double> bestFitnesses, ConstView<double> worstFitnesses, ConstView<double> avgFitnesses,
+		ConstView<int> bestCoefficients);
+	void finish(const RunResult &result);
+	int getSubmittedFrames();
+	int getRenderedFrames();
+	int getDroppedFrames();
+	~LivePlotter();
+};
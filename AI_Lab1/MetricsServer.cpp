@@ -0,0 +1,225 @@
+#include "stdafx.h"
+#include "MetricsServer.h"
+#include "Functions.h"
+#include <cstring>
+#include <sstream>
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// Wall clock seconds, the unit Prometheus compares time() with
+long long getUnixTime()
+{
+	return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Resident set size of the process in bytes, 0 where it is not known
+long long getResidentBytes()
+{
+#ifdef __linux__
+	std::ifstream statm("/proc/self/statm");
+	long long pages = 0, residentPages = 0;
+	if (statm >> pages >> residentPages)
+		return residentPages * sysconf(_SC_PAGESIZE);
+#endif
+	return 0;
+}
+
+RunMetrics::RunMetrics() : m_generations(0), m_evaluations(0), m_pointsTested(0), m_bestFitness(0.0), m_populationSize(0),
+	m_isRunning(false), m_startTime(getUnixTime())
+{
+	for (int p = 0; p < MetricsPhaseNum; p++)
+		m_phaseNanoseconds[p] = 0;
+	m_lastGenerationTime = m_startTime;
+}
+
+void RunMetrics::addGeneration(double bestFitness, int populationSize)
+{
+	m_generations.fetch_add(1, std::memory_order_relaxed);
+	m_bestFitness.store(bestFitness, std::memory_order_relaxed);
+	m_populationSize.store(populationSize, std::memory_order_relaxed);
+	m_lastGenerationTime.store(getUnixTime(), std::memory_order_relaxed);
+}
+
+void RunMetrics::addEvaluations(long long evaluations, long long pointsTested)
+{
+	m_evaluations.fetch_add(evaluations, std::memory_order_relaxed);
+	m_pointsTested.fetch_add(pointsTested, std::memory_order_relaxed);
+}
+
+void RunMetrics::addPhaseTime(MetricsPhase phase, std::chrono::steady_clock::duration time)
+{
+	m_phaseNanoseconds[phase].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(),
+		std::memory_order_relaxed);
+}
+
+void RunMetrics::setRunning(bool isRunning)
+{
+	m_isRunning.store(isRunning, std::memory_order_relaxed);
+}
+
+// Counts of the mixed precision fitness of this run, for the evaluators to add to
+MixedPrecisionCounts* RunMetrics::getMixedCounts()
+{
+	return &m_mixedCounts;
+}
+
+// Prometheus text exposition format 0.0.4
+std::string RunMetrics::format()
+{
+	const char *phaseNames[MetricsPhaseNum] = { "breeding", "evaluation", "statistics" };
+	long long mixedTested = m_mixedCounts.testedPoints.load(std::memory_order_relaxed);
+	long long mixedRetested = m_mixedCounts.retestedPoints.load(std::memory_order_relaxed);
+
+	std::ostringstream text;
+	text << "# HELP ga_generations_total Generations completed by the run.\n"
+		<< "# TYPE ga_generations_total counter\n"
+		<< "ga_generations_total " << m_generations.load(std::memory_order_relaxed) << "\n"
+		<< "# HELP ga_evaluations_total Fitness evaluations of individuals.\n"
+		<< "# TYPE ga_evaluations_total counter\n"
+		<< "ga_evaluations_total " << m_evaluations.load(std::memory_order_relaxed) << "\n"
+		<< "# HELP ga_points_tested_total Points of the sets the evaluated individuals were tested on.\n"
+		<< "# TYPE ga_points_tested_total counter\n"
+		<< "ga_points_tested_total " << m_pointsTested.load(std::memory_order_relaxed) << "\n"
+		<< "# HELP ga_phase_seconds_total Time spent in each phase of the generation loop.\n"
+		<< "# TYPE ga_phase_seconds_total counter\n";
+	for (int p = 0; p < MetricsPhaseNum; p++)
+		text << "ga_phase_seconds_total{phase=\"" << phaseNames[p] << "\"} "
+			<< m_phaseNanoseconds[p].load(std::memory_order_relaxed) / 1e9 << "\n";
+	text << "# HELP ga_mixed_precision_points_total Points classified by the mixed precision fitness.\n"
+		<< "# TYPE ga_mixed_precision_points_total counter\n"
+		<< "ga_mixed_precision_points_total " << mixedTested << "\n"
+		<< "# HELP ga_mixed_precision_retests_total Points the float32 pass left to the double test.\n"
+		<< "# TYPE ga_mixed_precision_retests_total counter\n"
+		<< "ga_mixed_precision_retests_total " << mixedRetested << "\n"
+		<< "# HELP ga_mixed_precision_hit_ratio Share of points decided by the float32 pass.\n"
+		<< "# TYPE ga_mixed_precision_hit_ratio gauge\n"
+		<< "ga_mixed_precision_hit_ratio " << (mixedTested > 0 ? 1.0 - (double)mixedRetested / mixedTested : 0.0) << "\n"
+		<< "# HELP ga_best_fitness Best fitness found by the run so far.\n"
+		<< "# TYPE ga_best_fitness gauge\n"
+		<< "ga_best_fitness " << m_bestFitness.load(std::memory_order_relaxed) << "\n"
+		<< "# HELP ga_population_size Children of the last completed generation.\n"
+		<< "# TYPE ga_population_size gauge\n"
+		<< "ga_population_size " << m_populationSize.load(std::memory_order_relaxed) << "\n"
+		<< "# HELP ga_running Whether the run is in progress.\n"
+		<< "# TYPE ga_running gauge\n"
+		<< "ga_running " << (m_isRunning.load(std::memory_order_relaxed) ? 1 : 0) << "\n"
+		<< "# HELP ga_start_time_seconds Start of the process since the Unix epoch.\n"
+		<< "# TYPE ga_start_time_seconds gauge\n"
+		<< "ga_start_time_seconds " << m_startTime << "\n"
+		<< "# HELP ga_last_generation_time_seconds End of the last completed generation since the Unix epoch.\n"
+		<< "# TYPE ga_last_generation_time_seconds gauge\n"
+		<< "ga_last_generation_time_seconds " << m_lastGenerationTime.load(std::memory_order_relaxed) << "\n"
+		<< "# HELP process_resident_memory_bytes Resident memory size in bytes.\n"
+		<< "# TYPE process_resident_memory_bytes gauge\n"
+		<< "process_resident_memory_bytes " << getResidentBytes() << "\n";
+	return text.str();
+}
+
+MetricsServer::MetricsServer(RunMetrics &metrics, const RunConfig &config)
+	: m_metrics(metrics), m_socketPath(config.metricsSocket), m_port(config.metricsPort), m_listenFd(-1), m_isStopping(false)
+{
+}
+
+MetricsServer::~MetricsServer()
+{
+	m_isStopping = true;
+	if (m_worker.joinable())
+		m_worker.join();
+#ifdef __linux__
+	if (m_listenFd >= 0)
+	{
+		close(m_listenFd);
+		if (!m_socketPath.empty())
+			unlink(m_socketPath.c_str());
+	}
+#endif
+}
+
+// Listens on the Unix socket if one is configured, otherwise on the loopback port, and starts serving
+bool MetricsServer::start()
+{
+#ifdef __linux__
+	if (!m_socketPath.empty())
+	{
+		m_listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		strncpy(address.sun_path, m_socketPath.c_str(), sizeof(address.sun_path) - 1);
+		unlink(m_socketPath.c_str());
+		if (m_listenFd < 0 || bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+		{
+			std::cerr << "Cannot serve metrics on " << m_socketPath << std::endl;
+			return false;
+		}
+	}
+	else
+	{
+		m_listenFd = socket(AF_INET, SOCK_STREAM, 0);
+		int reuse = 1;
+		setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = htons(static_cast<uint16_t>(m_port));
+		if (m_listenFd < 0 || bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+		{
+			std::cerr << "Cannot serve metrics on 127.0.0.1:" << m_port << std::endl;
+			return false;
+		}
+	}
+
+	if (listen(m_listenFd, 16) != 0)
+	{
+		std::cerr << "Cannot listen for metrics scrapes" << std::endl;
+		return false;
+	}
+	m_worker = std::thread(&MetricsServer::serveLoop, this);
+	std::cout << "Serving metrics on " << (m_socketPath.empty() ? "127.0.0.1:" + std::to_string(m_port) : m_socketPath)
+		<< std::endl;
+	return true;
+#else
+	std::cerr << "Metrics server requires Linux (Unix domain and loopback sockets)" << std::endl;
+	return false;
+#endif
+}
+
+// Answers every connection with the current metrics, whatever it asked for. The request is read
+// (for at most a short while) only so that the client does not see a reset before the response
+void MetricsServer::serveLoop()
+{
+#ifdef __linux__
+	char request[4096];
+	while (!m_isStopping)
+	{
+		pollfd listenPoll = { m_listenFd, POLLIN, 0 };
+		if (poll(&listenPoll, 1, 200) <= 0)
+			continue;
+		int client = accept(m_listenFd, nullptr, nullptr);
+		if (client < 0)
+			continue;
+
+		pollfd clientPoll = { client, POLLIN, 0 };
+		if (poll(&clientPoll, 1, 100) > 0)
+			read(client, request, sizeof(request));
+
+		std::string body = m_metrics.format();
+		std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+			std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+		size_t sent = 0;
+		while (sent < response.size())
+		{
+			ssize_t written = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+			if (written <= 0)
+				break;
+			sent += written;
+		}
+		close(client);
+	}
+#endif
+}
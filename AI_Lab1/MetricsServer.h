@@ -0,0 +1,62 @@
+#pragma once
+#include "stdafx.h"
+#include "Functions.h"
+#include "RunConfig.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+// Parts of a generation the run spends its time in. With the pipeline breeding overlaps evaluation
+// and both count as evaluation
+enum MetricsPhase
+{
+	BreedingPhase,
+	EvaluationPhase,
+	StatisticsPhase,
+	MetricsPhaseNum
+};
+
+// Counters and gauges of the running solve. The generation loop updates them with relaxed atomics,
+// so it never waits for a scrape; a scrape may see a generation half counted
+class RunMetrics
+{
+	std::atomic<long long> m_generations;
+	std::atomic<long long> m_evaluations;
+	std::atomic<long long> m_pointsTested;
+	std::atomic<long long> m_phaseNanoseconds[MetricsPhaseNum];
+	std::atomic<double> m_bestFitness;
+	std::atomic<int> m_populationSize;
+	std::atomic<bool> m_isRunning;
+	std::atomic<long long> m_lastGenerationTime;
+	long long m_startTime;
+	MixedPrecisionCounts m_mixedCounts;
+
+public:
+	RunMetrics();
+	void addGeneration(double bestFitness, int populationSize);
+	void addEvaluations(long long evaluations, long long pointsTested);
+	void addPhaseTime(MetricsPhase phase, std::chrono::steady_clock::duration time);
+	void setRunning(bool isRunning);
+	MixedPrecisionCounts* getMixedCounts();
+	std::string format();
+};
+
+// Serves the metrics in the Prometheus text format over HTTP on a Unix domain socket or on a loopback
+// TCP port, on its own thread. Every connection gets one response and is closed
+class MetricsServer
+{
+	RunMetrics &m_metrics;
+	std::string m_socketPath;
+	int m_port;
+	int m_listenFd;
+	std::atomic<bool> m_isStopping;
+	std::thread m_worker;
+
+	void serveLoop();
+
+public:
+	MetricsServer(RunMetrics &metrics, const RunConfig &config);
+	bool start();
+	~MetricsServer();
+};
@@ -0,0 +1,185 @@
+#include "stdafx.h"
+#include "OnlineSolver.h"
+#include "Functions.h"
+#include "GeneticAlgorithm.h"
+#include <cmath>
+
+// Starts with empty point sets and a random population
+OnlineSolver::OnlineSolver(const RunConfig &config) : m_config(config), m_generation(0), m_bestFitness(0.0)
+{
+	m_positiveSet = new PointSet(true);
+	m_negativeSet = new PointSet(false);
+	m_population = new Population(config.populationSize, config.polynomialDegree, config.minCoefficient, config.maxCoefficient);
+	m_operators = new GenerationOperators(config);
+	m_bestCoefficients.assign(config.polynomialDegree + 1, 0);
+}
+
+// Thread-safe, the point becomes visible to the algorithm at the next merge
+void OnlineSolver::submitPoint(Point point, bool isPositive)
+{
+	std::lock_guard<std::mutex> lock(m_pendingMutex);
+	if (isPositive)
+		m_pendingPositive.push_back(point);
+	else
+		m_pendingNegative.push_back(point);
+}
+
+// Appends pending points and tests every individual on them only, returns the number of merged points
+int OnlineSolver::mergePendingPoints()
+{
+	std::vector<Point> positive, negative;
+	{
+		std::lock_guard<std::mutex> lock(m_pendingMutex);
+		positive.swap(m_pendingPositive);
+		negative.swap(m_pendingNegative);
+	}
+
+	for (unsigned int i = 0; i < positive.size(); i++)
+		m_positiveSet->addPoint(positive.at(i));
+	for (unsigned int i = 0; i < negative.size(); i++)
+		m_negativeSet->addPoint(negative.at(i));
+
+	for (int i = 0; i < m_population->getPopulationSize(); i++)
+		updateFitness(*m_population->getCurveAt(i), *m_positiveSet, *m_negativeSet);
+
+	// Fitness of the former best changed with the data, so the best is taken from the current population
+	if (!positive.empty() || !negative.empty())
+	{
+		m_bestFitness = 0.0;
+		updateBest();
+	}
+
+	return positive.size() + negative.size();
+}
+
+void OnlineSolver::updateBest()
+{
+	for (int i = 0; i < m_population->getPopulationSize(); i++)
+	{
+		Curve *curve = m_population->getCurveAt(i);
+		if (curve->getFitness() > m_bestFitness)
+		{
+			m_bestFitness = curve->getFitness();
+			curve->getDecimalCoefficients(m_bestCoefficients);
+		}
+	}
+}
+
+void OnlineSolver::runGenerations(int generations)
+{
+	for (int g = 0; g < generations; g++)
+	{
+		mergePendingPoints();
+
+		double fitnessSum = 0;
+		int elite = 0;
+		for (int f = 0; f < m_population->getPopulationSize(); f++)
+		{
+			fitnessSum += m_population->getCurveAt(f)->getFitness();
+			if (m_population->getCurveAt(f)->getFitness() > m_population->getCurveAt(elite)->getFitness())
+				elite = f;
+		}
+
+		// The fittest individual is carried over with its hit counts, so the warm start is never lost
+		std::vector<Curve*> *newGenSet = new std::vector<Curve*>();
+		newGenSet->push_back(m_population->getCurveAt(elite));
+
+		if (m_config.useBitmaskOperators)
+		{
+			std::vector<ParentPair> pairs = chooseParentPairs(*m_population, m_config.populationSize - 1);
+			std::vector<Curve*> *children = m_operators->breed(*m_population, pairs, m_config.mutationRate);
+			newGenSet->insert(newGenSet->end(), children->begin(), children->end());
+			delete children;
+		}
+		else
+			for (int i = 1; i < m_config.populationSize; i++)
+			{
+				Curve *parent1 = ChooseParent(*m_population, fitnessSum);
+				Curve *parent2 = ChooseParent(*m_population, fitnessSum);
+				Curve *child = crossoverParents(*parent1, *parent2, m_config.crossoverProportion);
+
+				if (getRandomNumber(0.0, 1.0) < m_config.mutationRate)
+					for (int j = 0; j < child->getDegree() + 1; j++)
+						child->getCoefficientAt(j)->mutateCoefficient();
+				newGenSet->push_back(child);
+			}
+
+		// The previous generation is up to date after the merge, so a child with known coefficients
+		// takes over the hit counts and only a new child is tested on every point
+		std::map<std::vector<int>, const Curve*> known;
+		for (int i = 0; i < m_population->getPopulationSize(); i++)
+			known[m_population->getCurveAt(i)->getDecimalCoefficients()] = m_population->getCurveAt(i);
+		for (unsigned int i = 1; i < newGenSet->size(); i++)
+		{
+			std::map<std::vector<int>, const Curve*>::iterator match = known.find(newGenSet->at(i)->getDecimalCoefficients());
+			if (match != known.end())
+				newGenSet->at(i)->copyHits(*match->second);
+			updateFitness(*newGenSet->at(i), *m_positiveSet, *m_negativeSet);
+		}
+
+		// The elite moves to the new generation, the rest of the old one is deleted with it
+		m_population->replaceCurveAt(elite, nullptr);
+		int generationNum = m_population->getGenerationNum() + 1;
+		delete m_population;
+		m_population = new Population(newGenSet, generationNum);
+		m_generation++;
+
+		updateBest();
+		if (m_bestFitness == 1.00)
+			break;
+	}
+}
+
+// Merges new points and runs a number of generations proportional to the share of new data,
+// so that re-fitting after 1% new points runs about 1% of the generations of a full run. Returns the number of generations
+int OnlineSolver::refit()
+{
+	int totalBefore = m_positiveSet->getPointsetSize() + m_negativeSet->getPointsetSize();
+	int merged = mergePendingPoints();
+	if (merged == 0)
+		return 0;
+
+	int generations = m_config.maxGeneration;
+	if (totalBefore > 0)
+		generations = static_cast<int>(ceil((double)m_config.maxGeneration * merged / (totalBefore + merged)));
+
+	runGenerations(generations);
+	return generations;
+}
+
+int OnlineSolver::getGeneration()
+{
+	return m_generation;
+}
+
+double OnlineSolver::getBestFitness()
+{
+	return m_bestFitness;
+}
+
+std::vector<int> OnlineSolver::getBestCoefficients()
+{
+	return m_bestCoefficients;
+}
+
+PointSet& OnlineSolver::getPositiveSet()
+{
+	return *m_positiveSet;
+}
+
+PointSet& OnlineSolver::getNegativeSet()
+{
+	return *m_negativeSet;
+}
+
+OnlineSolver::~OnlineSolver()
+{
+	delete m_population;
+	m_population = nullptr;
+	delete m_operators;
+	m_operators = nullptr;
+	delete m_positiveSet;
+	m_positiveSet = nullptr;
+	delete m_negativeSet;
+	m_negativeSet = nullptr;
+}
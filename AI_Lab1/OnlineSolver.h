@@ -0,0 +1,45 @@
+#pragma once
+#include "stdafx.h"
+#include "Point.h"
+#include "PointSet.h"
+#include "Population.h"
+#include "GenerationOperators.h"
+#include "RunConfig.h"
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Genetic algorithm over point sets which keep growing. Points may be submitted from any thread and
+// are merged between generations. Fitness is kept incrementally: at a merge the population is tested on the
+// new points only, and a child equal to a curve of the previous generation (a converged population breeds many)
+// takes over its hit counts instead of being tested again. Only children with new coefficients are tested on
+// every point; the population is also kept across batches as a warm start
+class OnlineSolver
+{
+	RunConfig m_config;
+	PointSet *m_positiveSet;
+	PointSet *m_negativeSet;
+	Population *m_population;
+	GenerationOperators *m_operators;
+	std::vector<Point> m_pendingPositive;
+	std::vector<Point> m_pendingNegative;
+	std::mutex m_pendingMutex;
+	int m_generation;
+	double m_bestFitness;
+	std::vector<int> m_bestCoefficients;
+
+	void updateBest();
+
+public:
+	OnlineSolver(const RunConfig &config);
+	void submitPoint(Point point, bool isPositive);
+	int mergePendingPoints();
+	void runGenerations(int generations);
+	int refit();
+	int getGeneration();
+	double getBestFitness();
+	std::vector<int> getBestCoefficients();
+	PointSet& getPositiveSet();
+	PointSet& getNegativeSet();
+	~OnlineSolver();
+};
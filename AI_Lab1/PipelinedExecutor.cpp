@@ -0,0 +1,207 @@
+#include "stdafx.h"
+#include "PipelinedExecutor.h"
+#include "Functions.h"
+#include "RandomNumberGenerator.h"
+#include <algorithm>
+#include <chrono>
+
+// Tasks waiting for one worker, a few are enough to hide the hand-over
+const int queueCapacity = 4;
+
+// Empty polls of a worker before it starts sleeping between polls
+const int idleSpins = 1000;
+
+PipelinedExecutor::PipelinedExecutor(const RunConfig &config, const PointSet &positiveSet, const PointSet &negativeSet,
+	MixedPrecisionCounts *mixedCounts)
+	: m_crossoverProportion(config.crossoverProportion), m_mutationRate(config.mutationRate),
+	m_useMixedPrecision(config.useMixedPrecision), m_mixedCounts(mixedCounts), m_positiveSet(positiveSet), m_negativeSet(negativeSet), m_isStopping(false),
+	m_nextWorker(0), m_inFlight(0)
+{
+	int workerNum = std::max(1, config.pipelineThreads);
+	for (int w = 0; w < workerNum; w++)
+	{
+		m_tasks.push_back(new BoundedQueue<PipelineTask>(queueCapacity));
+		m_results.push_back(new BoundedQueue<PipelineTask>(queueCapacity));
+	}
+	for (int w = 0; w < workerNum; w++)
+		m_workers.push_back(std::thread(&PipelinedExecutor::workerLoop, this, w));
+}
+
+// Children still in the pipeline belong to the executor
+PipelinedExecutor::~PipelinedExecutor()
+{
+	m_isStopping = true;
+	for (unsigned int w = 0; w < m_workers.size(); w++)
+		m_workers.at(w).join();
+
+	PipelineTask task;
+	for (unsigned int w = 0; w < m_workers.size(); w++)
+	{
+		while (m_tasks.at(w)->tryPop(task))
+			delete task.curve;
+		while (m_results.at(w)->tryPop(task))
+			delete task.curve;
+		delete m_tasks.at(w);
+		delete m_results.at(w);
+	}
+}
+
+int PipelinedExecutor::getWorkerNum()
+{
+	return static_cast<int>(m_workers.size());
+}
+
+void PipelinedExecutor::workerLoop(int worker)
+{
+	BoundedQueue<PipelineTask> &tasks = *m_tasks.at(worker);
+	BoundedQueue<PipelineTask> &results = *m_results.at(worker);
+	int idle = 0;
+	PipelineTask task;
+	while (!m_isStopping)
+	{
+		if (!tasks.tryPop(task))
+		{
+			// Spin while the coordinator is breeding, sleep when it is busy with something else
+			if (++idle < idleSpins)
+				std::this_thread::yield();
+			else
+				std::this_thread::sleep_for(std::chrono::microseconds(50));
+			continue;
+		}
+
+		idle = 0;
+		task.fitness = m_useMixedPrecision ? calculateMixedFitness(*task.curve, m_positiveSet, m_negativeSet, m_mixedCounts) :
+			calculateFitness(*task.curve, m_positiveSet, m_negativeSet);
+		while (!results.tryPush(task))
+		{
+			if (m_isStopping)
+			{
+				delete task.curve;
+				return;
+			}
+			std::this_thread::yield();
+		}
+	}
+}
+
+// One point crossover of both parents and mutation of the child, the same operators as the sequential loop
+Curve* PipelinedExecutor::breedChild(Population &population, const ParentPair &parents)
+{
+	Curve *child = crossoverParents(*population.getCurveAt(parents.first), *population.getCurveAt(parents.second),
+		m_crossoverProportion);
+	if (getRandomNumber(0.0, 1.0) < m_mutationRate)
+		for (int j = 0; j < child->getDegree() + 1; j++)
+			child->getCoefficientAt(j)->mutateCoefficient();
+	return child;
+}
+
+// Offers the task to the workers round robin, fails when every queue is full
+bool PipelinedExecutor::pushTask(const PipelineTask &task)
+{
+	int workerNum = getWorkerNum();
+	for (int k = 0; k < workerNum; k++)
+	{
+		int worker = (m_nextWorker + k) % workerNum;
+		if (m_tasks.at(worker)->tryPush(task))
+		{
+			m_nextWorker = (worker + 1) % workerNum;
+			m_inFlight++;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Breeds and evaluates a whole generation. Children get their fitness set and keep their order; when the control stops
+// the run no further children are bred, and the returned number of children, all of them evaluated, may be less than childNum
+int PipelinedExecutor::breedGeneration(Population &population, int childNum, std::vector<Curve*> &children,
+	std::vector<ParentPair> &pairs, const SolveControl &control)
+{
+	pairs = chooseParentPairs(population, childNum);
+	children.assign(childNum, nullptr);
+
+	int bred = 0, received = 0;
+	Curve *next = nullptr;
+	bool isStopped = false;
+	PipelineTask task;
+	while (received < bred || (bred < childNum && !isStopped))
+	{
+		bool progressed = false;
+		for (int w = 0; w < getWorkerNum(); w++)
+			while (m_results.at(w)->tryPop(task))
+			{
+				task.curve->setFitness(task.fitness);
+				children.at(task.child) = task.curve;
+				received++;
+				m_inFlight--;
+				progressed = true;
+			}
+
+		if (bred < childNum && !isStopped)
+		{
+			isStopped = control.shouldStop();
+			if (next == nullptr && !isStopped)
+				next = breedChild(population, pairs.at(bred));
+			if (next != nullptr && !isStopped && pushTask(PipelineTask{ bred, next, 0.0 }))
+			{
+				next = nullptr;
+				bred++;
+				progressed = true;
+			}
+		}
+
+		if (!progressed)
+			std::this_thread::yield();
+	}
+
+	delete next;
+	children.resize(bred);
+	pairs.resize(bred);
+	return bred;
+}
+
+// Asynchronous steady state: children are bred from the current population as long as the queues have room,
+// and every evaluated child replaces the worst individual unless it is worse. There is no generation barrier,
+// children bred for the next call stay in flight. Returns the number of children received
+int PipelinedExecutor::evaluateSteadyState(Population &population, int evaluationNum, const SolveControl &control)
+{
+	int received = 0;
+	PipelineTask task;
+	while (received < evaluationNum && !control.shouldStop())
+	{
+		bool progressed = false;
+		for (int w = 0; w < getWorkerNum(); w++)
+			while (m_results.at(w)->tryPop(task))
+			{
+				m_inFlight--;
+				received++;
+				progressed = true;
+
+				int worst = 0;
+				for (int i = 1; i < population.getPopulationSize(); i++)
+					if (population.getCurveAt(i)->getFitness() < population.getCurveAt(worst)->getFitness())
+						worst = i;
+				task.curve->setFitness(task.fitness);
+				if (task.fitness >= population.getCurveAt(worst)->getFitness())
+					delete population.replaceCurveAt(worst, task.curve);
+				else
+					delete task.curve;
+			}
+
+		// Keep every worker busy, parents come from the population as it is now
+		while (m_inFlight < getWorkerNum() * queueCapacity)
+		{
+			Curve *child = breedChild(population, chooseParentPairs(population, 1).at(0));
+			if (!pushTask(PipelineTask{ 0, child, 0.0 }))
+			{
+				delete child;
+				break;
+			}
+			progressed = true;
+		}
+
+		if (!progressed)
+			std::this_thread::yield();
+	}
+	return received;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "stdafx.h"
+#include "BoundedQueue.h"
+#include "Curve.h"
+#include "GenerationOperators.h"
+#include "PointSet.h"
+#include "Population.h"
+#include "RunConfig.h"
+#include "SolveControl.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+struct MixedPrecisionCounts;
+
+// One child travelling through the pipeline, the worker fills in the fitness
+struct PipelineTask
+{
+	int child;
+	Curve *curve;
+	double fitness;
+};
+
+// Overlaps breeding and evaluation. The calling thread selects parents, crosses and mutates one child at a time
+// and hands it to an evaluation worker through a bounded lock-free queue, so breeding of the next child runs
+// while the previous ones are evaluated. Every worker has its own task and result queue, each with a single
+// producer and a single consumer. Evaluation is the plain calculateFitness or its mixed precision twin, which
+// adds its points to the optional counts of the run
+class PipelinedExecutor
+{
+	double m_crossoverProportion;
+	double m_mutationRate;
+	bool m_useMixedPrecision;
+	MixedPrecisionCounts *m_mixedCounts;
+	const PointSet &m_positiveSet;
+	const PointSet &m_negativeSet;
+	std::vector<BoundedQueue<PipelineTask>*> m_tasks;
+	std::vector<BoundedQueue<PipelineTask>*> m_results;
+	std::vector<std::thread> m_workers;
+	std::atomic<bool> m_isStopping;
+	int m_nextWorker;
+	int m_inFlight;
+
+	void workerLoop(int worker);
+	Curve* breedChild(Population &population, const ParentPair &parents);
+	bool pushTask(const PipelineTask &task);
+
+public:
+	PipelinedExecutor(const RunConfig &config, const PointSet &positiveSet, const PointSet &negativeSet,
+		MixedPrecisionCounts *mixedCounts = nullptr);
+	int breedGeneration(Population &population, int childNum, std::vector<Curve*> &children, std::vector<ParentPair> &pairs,
+		const SolveControl &control);
+	int evaluateSteadyState(Population &population, int evaluationNum, const SolveControl &control);
+	int getWorkerNum();
+	~PipelinedExecutor();
+};
@@ -28,6 +28,6 @@ Point::Point(bool isPositive, double minX, double maxX, double minY, double maxY
 Point::Point(double x, double y) : m_x(x), m_y(y) {}
 void Point::setX(double x) { m_x = x; }
 void Point::setY(double y) { m_y = y; }
-double Point::getX() { return m_x; }
-double Point::getY() { return m_y; }
-void Point::printPoint() { std::cout << "(" << m_x << ", " << m_y << ")"; }
\ No newline at end of file
+double Point::getX() const { return m_x; }
+double Point::getY() const { return m_y; }
+void Point::printPoint() const { std::cout << "(" << m_x << ", " << m_y << ")"; }
\ No newline at end of file
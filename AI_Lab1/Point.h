@@ -15,8 +15,8 @@ public:
 	void setY(double y);
 	
 	// Accessors
-	double getX();
-	double getY();
+	double getX() const;
+	double getY() const;
 
-	void printPoint();
+	void printPoint() const;
 };
@@ -0,0 +1,156 @@
+#include "stdafx.h"
+#include "PointGenerator.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// SplitMix64 finalizer, a stateless hash used as counter-based random generator
+inline uint64_t mixBits(uint64_t value)
+{
+	value += 0x9E3779B97F4A7C15ULL;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	return value ^ (value >> 31);
+}
+
+// Counters of one point, a draw number must stay below it or it repeats a draw of the next point
+const uint64_t drawsPerPoint = 128;
+
+// Uniform number in [0, 1) for the given point, draw number and seed
+inline double uniformAt(uint64_t seed, uint64_t index, uint64_t draw)
+{
+	uint64_t bits = mixBits(seed ^ mixBits(index * drawsPerPoint + draw));
+	return (bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+bool parsePointDistribution(const std::string &name, PointDistribution &distribution)
+{
+	if (name == "split")
+		distribution = PointDistribution::Split;
+	else if (name == "gaussian")
+		distribution = PointDistribution::GaussianClusters;
+	else if (name == "curve")
+		distribution = PointDistribution::CurveSeparated;
+	else
+		return false;
+	return true;
+}
+
+double evaluateCurve(const std::vector<double> &curve, double x)
+{
+	double value = 0.0;
+	for (unsigned int k = 0; k < curve.size(); k++)
+		value = value * x + curve[k];
+	return value;
+}
+
+// Generates points with indices [begin, end)
+void generateRange(const GeneratorConfig &config, long long positiveNum, long long begin, long long end, PointBuffer &buffer)
+{
+	const double pi = 3.14159265358979323846;
+	const uint64_t maxAttempts = 7;
+	const uint64_t fallbackSteps = 64;
+	// Draws of the curve separated points: x and y of the attempts, the fallback start, the label noise and the fallback y
+	const uint64_t fallbackStartDraw = 2 * maxAttempts;
+	const uint64_t labelNoiseDraw = 15;
+	const uint64_t fallbackDraw = 16;
+	static_assert(fallbackStartDraw < labelNoiseDraw && fallbackDraw + fallbackSteps <= drawsPerPoint,
+		"Draws of one point should not overlap or reach the next point");
+	double *x = buffer.x.data();
+	double *y = buffer.y.data();
+	unsigned char *labels = buffer.labels.data();
+	uint64_t seed = config.seed;
+
+	switch (config.distribution)
+	{
+		case PointDistribution::Split:
+			for (long long i = begin; i < end; i++)
+			{
+				bool isPositive = i < positiveNum;
+				double u = uniformAt(seed, i, 0);
+				x[i] = isPositive ? config.minX + u * (-1.0 - config.minX) : 1.0 + u * (config.maxX - 1.0);
+				y[i] = config.minY + uniformAt(seed, i, 1) * (config.maxY - config.minY);
+				labels[i] = isPositive;
+			}
+			break;
+
+		case PointDistribution::GaussianClusters:
+		{
+			double centreY = (config.minY + config.maxY) / 2;
+			for (long long i = begin; i < end; i++)
+			{
+				bool isPositive = i < positiveNum;
+				double centreX = isPositive ? config.minX / 2 : config.maxX / 2;
+
+				// Box-Muller transform of two uniform numbers
+				double radius = sqrt(-2.0 * log(1.0 - uniformAt(seed, i, 0))) * config.sigma;
+				double angle = 2.0 * pi * uniformAt(seed, i, 1);
+				x[i] = centreX + radius * cos(angle);
+				y[i] = centreY + radius * sin(angle);
+				labels[i] = isPositive;
+			}
+			break;
+		}
+
+		case PointDistribution::CurveSeparated:
+			for (long long i = begin; i < end; i++)
+			{
+				bool isPositive = i < positiveNum;
+
+				// Rejection sampling, the attempt number is part of the counter so the result stays deterministic.
+				// When the random attempts fail, x steps through evenly spaced positions from a random start,
+				// so a side with room anywhere in the area still gets a point there
+				double px = 0.0, py = 0.0;
+				bool isPlaced = false;
+				for (uint64_t attempt = 0; attempt < maxAttempts + fallbackSteps && !isPlaced; attempt++)
+				{
+					double position = attempt < maxAttempts ? uniformAt(seed, i, 2 * attempt) :
+						fmod(uniformAt(seed, i, fallbackStartDraw) + (double)(attempt - maxAttempts) / fallbackSteps, 1.0);
+					px = config.minX + position * (config.maxX - config.minX);
+					double curveY = evaluateCurve(config.curve, px);
+					double lo = isPositive ? std::max(config.minY, curveY + config.margin) : config.minY;
+					double hi = isPositive ? config.maxY : std::min(config.maxY, curveY - config.margin);
+					if (lo < hi)
+					{
+						// Fallback steps draw y after the label noise counter, each from its own counter
+						uint64_t counter = attempt < maxAttempts ? 2 * attempt + 1 : fallbackDraw + attempt - maxAttempts;
+						py = lo + uniformAt(seed, i, counter) * (hi - lo);
+						isPlaced = true;
+					}
+				}
+
+				// No room on this side anywhere in the area: the point stays inside the bounds on the nearest edge
+				if (!isPlaced)
+					py = isPositive ? config.maxY : config.minY;
+				x[i] = px;
+				y[i] = py;
+				labels[i] = isPositive;
+			}
+			break;
+	}
+
+	if (config.labelNoise > 0.0)
+		for (long long i = begin; i < end; i++)
+			labels[i] ^= static_cast<unsigned char>(uniformAt(seed, i, labelNoiseDraw) < config.labelNoise);
+}
+
+void generatePoints(const GeneratorConfig &config, long long positiveNum, long long negativeNum, int threads, PointBuffer &buffer)
+{
+	const long long chunkSize = 1 << 16;
+	long long pointNum = positiveNum + negativeNum;
+	buffer.x.resize(pointNum);
+	buffer.y.resize(pointNum);
+	buffer.labels.resize(pointNum);
+
+	ThreadPool pool(threads);
+	for (long long begin = 0; begin < pointNum; begin += chunkSize)
+	{
+		long long end = std::min(begin + chunkSize, pointNum);
+		pool.submit([&config, &buffer, positiveNum, begin, end]
+		{
+			generateRange(config, positiveNum, begin, end, buffer);
+		});
+	}
+	pool.wait();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "stdafx.h"
+#include <string>
+#include <vector>
+
+// Layout of generated points
+enum class PointDistribution
+{
+	Split,				// uniform, positive points left of x = -1 and negative ones right of x = 1
+	GaussianClusters,	// two normal clusters centred in the left and right half of the area
+	CurveSeparated		// uniform in the area, positive above the reference curve and negative below, off by margin
+};
+
+// Parameters of generated point sets
+struct GeneratorConfig
+{
+	PointDistribution distribution;
+	double minX;
+	double maxX;
+	double minY;
+	double maxY;
+	double sigma;
+	std::vector<double> curve;
+	double margin;
+	double labelNoise;
+	unsigned long long seed;
+};
+
+// Points as structure of arrays, label is 1 for the positive set
+struct PointBuffer
+{
+	std::vector<double> x;
+	std::vector<double> y;
+	std::vector<unsigned char> labels;
+};
+
+// Parses "split", "gaussian" or "curve"
+bool parsePointDistribution(const std::string &name, PointDistribution &distribution);
+
+// Fills pre-sized buffer with positiveNum positive and then negativeNum negative points in parallel chunks.
+// Every point is drawn from a counter-based generator keyed by seed and point index, so the result only
+// depends on the seed and not on the number of threads. With label noise a point keeps its position
+// but its label is flipped with the given probability
+void generatePoints(const GeneratorConfig &config, long long positiveNum, long long negativeNum, int threads, PointBuffer &buffer);
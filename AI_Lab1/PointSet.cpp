@@ -1,16 +1,58 @@
 #include "stdafx.h"
 #include "Point.h"
 #include "PointSet.h"
+#include "PointGenerator.h"
+#include <algorithm>
+#include <cmath>
 
-PointSet::PointSet(int pointNum, bool isPositive, double minX, double maxX, double minY, double maxY) : m_isPositive(isPositive)
+// Largest m for which points with x = a / 2^m are merged on the lattice of polynomial values
+const int maxLatticeBits = 16;
+
+PointSet::PointSet(int pointNum, bool isPositive, double minX, double maxX, double minY, double maxY)
+	: m_totalWeight(0), m_isPositive(isPositive)
 {
 	m_pointSet = new std::vector<Point>();
+	m_pointSet->reserve(pointNum);
 	
 	for(int i = 0; i < pointNum; i++)
 		m_pointSet->push_back(Point(isPositive, minX, maxX, minY, maxY));
+	updateFloatPoints();
+}
+
+// Creates empty set for points which arrive later
+PointSet::PointSet(bool isPositive) : m_totalWeight(0), m_isPositive(isPositive)
+{
+	m_pointSet = new std::vector<Point>();
 }
 
-void PointSet::printSet()
+// Takes points of the generated buffer which carry the label of this set
+PointSet::PointSet(PointBuffer &buffer, bool isPositive) : m_totalWeight(0), m_isPositive(isPositive)
+{
+	unsigned char label = isPositive ? 1 : 0;
+	m_pointSet = new std::vector<Point>();
+	m_pointSet->reserve(std::count(buffer.labels.begin(), buffer.labels.end(), label));
+
+	for (unsigned int i = 0; i < buffer.labels.size(); i++)
+		if (buffer.labels[i] == label)
+			m_pointSet->push_back(Point(buffer.x[i], buffer.y[i]));
+	updateFloatPoints();
+}
+
+void PointSet::addPoint(Point point)
+{
+	m_pointSet->push_back(point);
+	m_weights.push_back(1);
+	m_totalWeight++;
+	m_floatX.push_back(static_cast<float>(point.getX()));
+	m_floatY.push_back(static_cast<float>(point.getY()));
+}
+
+bool PointSet::isPositive() const
+{
+	return m_isPositive;
+}
+
+void PointSet::printSet() const
 {
 	for (unsigned int i = 0; i < m_pointSet->size(); i++)
 	{
@@ -19,22 +61,148 @@ void PointSet::printSet()
 
 }
 
-int PointSet::getPointsetSize()
+int PointSet::getPointsetSize() const
 {
 	return m_pointSet->size();
 }
 
-Point PointSet::getPointAt(unsigned int idx)
+const Point& PointSet::getPointAt(unsigned int idx) const
 {
 	return m_pointSet->at(idx);
 }
 
-std::vector<Point> PointSet::getPoints()
+// Float32 copies of the coordinates, invalidated like getPoints
+ConstView<float> PointSet::getFloatX() const
+{
+	return ConstView<float>(m_floatX);
+}
+
+ConstView<float> PointSet::getFloatY() const
+{
+	return ConstView<float>(m_floatY);
+}
+
+// Number of original points each stored point stands for, all 1 until compactPoints merges some
+ConstView<int> PointSet::getWeights() const
+{
+	return ConstView<int>(m_weights);
+}
+
+// Number of original points, the denominator of fitness
+int PointSet::getTotalWeight() const
+{
+	return m_totalWeight;
+}
+
+// Merges points which every curve puts on the same side into one point whose weight is their number, and
+// returns the number of stored points left. Exact duplicates are always merged. With useLattice, points with
+// the same x = a / 2^m are merged when their y fall between the same two neighbouring values that any
+// polynomial of degree <= maxDegree with integer coefficients can take there: p(x) is a multiple of
+// 2^(-m * maxDegree), and while |p(x)| * 2^(m * maxDegree) < 2^52 it is computed exactly in double,
+// so y > p(x) exactly when ceil(y * 2^(m * maxDegree)) > p(x) * 2^(m * maxDegree). The first point of
+// every group stays in its place
+int PointSet::compactPoints(bool useLattice, int maxDegree, int maxAbsCoefficient)
+{
+	struct PointKey
+	{
+		double x;
+		double key;
+		int idx;
+	};
+
+	std::vector<PointKey> keys;
+	keys.reserve(m_pointSet->size());
+	for (unsigned int i = 0; i < m_pointSet->size(); i++)
+	{
+		double x = m_pointSet->at(i).getX();
+		double y = m_pointSet->at(i).getY();
+		keys.push_back(PointKey{ x, y, static_cast<int>(i) });
+		if (!useLattice)
+			continue;
+
+		// Smallest m with x * 2^m integer, and the largest |p(x)| any curve can reach
+		int m = 0;
+		while (m <= maxLatticeBits && std::ldexp(x, m) != std::floor(std::ldexp(x, m)))
+			m++;
+		double reach = 0.0;
+		for (int k = 0; k <= maxDegree; k++)
+			reach += maxAbsCoefficient * std::pow(std::fabs(x), k);
+		int scaleBits = m * maxDegree;
+		if (m <= maxLatticeBits && std::ldexp(reach, scaleBits) < std::ldexp(1.0, 52))
+			keys.back().key = std::ceil(std::ldexp(y, scaleBits));
+	}
+
+	std::sort(keys.begin(), keys.end(), [](const PointKey &a, const PointKey &b)
+		{ return a.x != b.x ? a.x < b.x : (a.key != b.key ? a.key < b.key : a.idx < b.idx); });
+
+	// Weight of every group goes to its first point, the others get weight 0 and are dropped below
+	std::vector<int> weights(m_weights);
+	for (unsigned int i = 1; i < keys.size(); i++)
+	{
+		PointKey &first = keys.at(i - 1);
+		if (keys.at(i).x == first.x && keys.at(i).key == first.key)
+		{
+			weights.at(first.idx) += weights.at(keys.at(i).idx);
+			weights.at(keys.at(i).idx) = 0;
+			keys.at(i).idx = first.idx;
+		}
+	}
+
+	std::vector<Point> *compacted = new std::vector<Point>();
+	m_weights.clear();
+	for (unsigned int i = 0; i < m_pointSet->size(); i++)
+		if (weights.at(i) > 0)
+		{
+			compacted->push_back(m_pointSet->at(i));
+			m_weights.push_back(weights.at(i));
+		}
+
+	delete m_pointSet;
+	m_pointSet = compacted;
+	updateFloatPoints();
+	return static_cast<int>(m_pointSet->size());
+}
+
+// View of the stored points, invalidated by addPoint and reorderPoints
+ConstView<Point> PointSet::getPoints() const
+{
+	return ConstView<Point>(*m_pointSet);
+}
+
+// Rearranges points so that the new i-th point is the old point at order[i]
+void PointSet::reorderPoints(std::vector<int> &order)
+{
+	std::vector<Point> *reordered = new std::vector<Point>();
+	std::vector<int> weights;
+	reordered->reserve(order.size());
+	for (unsigned int i = 0; i < order.size(); i++)
+	{
+		reordered->push_back(m_pointSet->at(order.at(i)));
+		weights.push_back(m_weights.at(order.at(i)));
+	}
+
+	delete m_pointSet;
+	m_pointSet = reordered;
+	m_weights = weights;
+	updateFloatPoints();
+}
+
+// Rounds every point to float32 into separate x and y arrays for the mixed precision fitness.
+// Points without a weight yet (new sets) get weight 1
+void PointSet::updateFloatPoints()
 {
-	std::vector<Point> points;
+	m_weights.resize(m_pointSet->size(), 1);
+	m_totalWeight = 0;
+	for (unsigned int i = 0; i < m_weights.size(); i++)
+		m_totalWeight += m_weights[i];
+
+	m_floatX.resize(m_pointSet->size());
+	m_floatY.resize(m_pointSet->size());
 	for (unsigned int i = 0; i < m_pointSet->size(); i++)
-		points.push_back(m_pointSet->at(i));
-	return points;
+	{
+		m_floatX[i] = static_cast<float>(m_pointSet->at(i).getX());
+		m_floatY[i] = static_cast<float>(m_pointSet->at(i).getY());
+	}
 }
 
 PointSet::~PointSet()
@@ -1,20 +1,39 @@
 #pragma once
 #include "stdafx.h"
+#include "ConstView.h"
 #include <vector>
 
+struct PointBuffer;
+
 
 // A PointSet class represents a positive or negative set of points
 class PointSet
 {
 	std::vector<Point> *m_pointSet;
+	std::vector<float> m_floatX;
+	std::vector<float> m_floatY;
+	std::vector<int> m_weights;
+	int m_totalWeight;
 	bool m_isPositive;
 
+	void updateFloatPoints();
+
 public:
 	PointSet(int pointNum, bool isPositive, double minX, double maxX, double minY, double maxY);
-	std::vector<Point> getPoints();
-	Point getPointAt(unsigned int idx);
-	int getPointsetSize();
-	void printSet();
+	PointSet(bool isPositive);
+	PointSet(PointBuffer &buffer, bool isPositive);
+	ConstView<Point> getPoints() const;
+	const Point& getPointAt(unsigned int idx) const;
+	ConstView<float> getFloatX() const;
+	ConstView<float> getFloatY() const;
+	ConstView<int> getWeights() const;
+	int getTotalWeight() const;
+	int getPointsetSize() const;
+	void reorderPoints(std::vector<int> &order);
+	void addPoint(Point point);
+	int compactPoints(bool useLattice, int maxDegree, int maxAbsCoefficient);
+	bool isPositive() const;
+	void printSet() const;
 	~PointSet();
 };
 
@@ -2,18 +2,19 @@
 #include "Population.h"
 
 
+// Creates the first generation of random curves, it is generation 0 as in the exported fitness series
 Population::Population(int populationSize, int degree, int minCoefficient, int maxCoefficient) : m_populationSize(populationSize)
 {
-	m_generationNum++;
+	m_generationNum = 0;
 	m_populationSet = new std::vector<Curve*>();
 	for (int i = 0; i < m_populationSize; i++)
 		m_populationSet->push_back(new Curve(degree, minCoefficient, maxCoefficient));
 }
 
-Population::Population(std::vector<Curve*> *generationSet)
+// Creates the generation with given number from bred curves
+Population::Population(std::vector<Curve*> *generationSet, int generationNum) : m_generationNum(generationNum)
 {
 	m_populationSize = generationSet->size();
-	m_generationNum++;
 	m_populationSet = generationSet;
 }
 
@@ -42,10 +43,20 @@ Curve* Population::getCurveAt(int idx)
 	return m_populationSet->at(idx);
 }
 
-int Population::m_generationNum = 0;
+// Puts the curve in place of the individual at idx and returns the replaced one, which the caller deletes.
+// Replacing with nullptr takes the individual out of the population before it is deleted
+Curve* Population::replaceCurveAt(int idx, Curve *curve)
+{
+	Curve *replaced = m_populationSet->at(idx);
+	m_populationSet->at(idx) = curve;
+	return replaced;
+}
 
+// The population owns its individuals
 Population::~Population()
 {
+	for (unsigned int i = 0; i < m_populationSet->size(); i++)
+		delete m_populationSet->at(i);
 	delete m_populationSet;
 	m_populationSet = nullptr;
 }
@@ -6,16 +6,17 @@
 class Population
 {
 	int m_populationSize;
-	static int m_generationNum;
+	int m_generationNum;
 	std::vector<Curve*> *m_populationSet;
 
 
 public:
 	Population(int populationSize, int degree, int minCoefficient, int maxCoefficient);
-	Population(std::vector<Curve*> *generationSet);
+	Population(std::vector<Curve*> *generationSet, int generationNum);
 	//Population(int populationSize, int degree, std::vector<Curve> &populationSet);
 	int getPopulationSize();
 	Curve* getCurveAt(int idx);
+	Curve* replaceCurveAt(int idx, Curve *curve);
 	int getGenerationNum();
 	void printPopulation();
 	~Population();
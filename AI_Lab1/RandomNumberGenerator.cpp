@@ -1,19 +1,40 @@
 #include "RandomNumberGenerator.h"
 #include "stdafx.h"
 
+// Mersenne Twister of the calling thread, so that concurrent runs do not share state
+std::mt19937& getMersenne()
+{
+	thread_local std::mt19937 mersenne{ std::random_device{}() };
+	return mersenne;
+}
+
+void seedRandomNumberGenerator(unsigned int seed)
+{
+	getMersenne().seed(seed);
+}
+
+std::mt19937 saveRandomNumberGenerator()
+{
+	return getMersenne();
+}
+
+void restoreRandomNumberGenerator(const std::mt19937 &state)
+{
+	getMersenne() = state;
+}
+
 // Generates random integer number from min to max using Mersenne Twister
 int getRandomNumber(int min, int max)
 {
-	static std::random_device rd;
-	static std::mt19937 mersenne{ rd() };
+	std::mt19937 &mersenne = getMersenne();
 	static const double fraction = 1.0 / (static_cast<double>(mersenne.max()) + 1.0);
 	return min + static_cast<int>((max - min + 1) * (mersenne() * fraction));
 }
 
+// Generates random real number from [min, max)
 double getRandomNumber(double min, double max)
 {
-	static std::random_device rd;
-	static std::mt19937 mersenne{ rd() };
+	std::mt19937 &mersenne = getMersenne();
 	static const double fraction = 1.0 / (static_cast<double>(mersenne.max()) + 1.0);
-	return min + ((max - min + 1) * (mersenne() * fraction));
+	return min + ((max - min) * (mersenne() * fraction));
 }
@@ -1,5 +1,14 @@
 #pragma once
+#include <random>
 
 int getRandomNumber(int min, int max);
 double getRandomNumber(double min, double max);
-float getFloatBetweenZeroAndOne();
\ No newline at end of file
+float getFloatBetweenZeroAndOne();
+
+// Reseeds the generator of the calling thread, every thread starts with its own random_device seed
+void seedRandomNumberGenerator(unsigned int seed);
+
+// State of the generator of the calling thread, restoring it replays the same numbers. Work which must not
+// shift a seeded run (like profiling) saves the state before and restores it after
+std::mt19937 saveRandomNumberGenerator();
+void restoreRandomNumberGenerator(const std::mt19937 &state);
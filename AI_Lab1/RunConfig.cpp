@@ -0,0 +1,372 @@
+#include "stdafx.h"
+#include "RunConfig.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+// Splits comma separated list of values
+std::vector<std::string> splitValues(const std::string &value)
+{
+	std::vector<std::string> values;
+	std::stringstream stream(value);
+	std::string item;
+	while (std::getline(stream, item, ','))
+		if (!item.empty())
+			values.push_back(item);
+	return values;
+}
+
+std::string trim(const std::string &text)
+{
+	size_t first = text.find_first_not_of(" \t\r\n");
+	if (first == std::string::npos)
+		return "";
+	size_t last = text.find_last_not_of(" \t\r\n");
+	return text.substr(first, last - first + 1);
+}
+
+bool parseBool(const std::string &value)
+{
+	return value == "1" || value == "true" || value == "yes" || value == "on";
+}
+
+// Parses the whole text as one value, anything left after it except blanks makes the value invalid
+template <typename T>
+T parseValue(const std::string &text)
+{
+	std::stringstream stream(text);
+	T value;
+	if (!(stream >> value) || !(stream >> std::ws).eof())
+		throw std::invalid_argument(text);
+	return value;
+}
+
+// Parses list of values for a sweepable parameter, a single value goes to the config, several to the grid
+template <typename T>
+void applyList(const std::vector<std::string> &values, T &configValue, std::vector<T> &gridValues)
+{
+	std::vector<T> parsed;
+	for (unsigned int i = 0; i < values.size(); i++)
+		parsed.push_back(parseValue<T>(values.at(i)));
+
+	if (parsed.size() == 1)
+		configValue = parsed.at(0);
+	else
+		gridValues = parsed;
+}
+
+bool applyConfigValue(RunConfig &config, SweepGrid &grid, const std::string &key, const std::string &value)
+{
+	std::vector<std::string> values = splitValues(trim(value));
+	if (values.empty())
+	{
+		std::cerr << "Missing value for " << key << std::endl;
+		return false;
+	}
+
+	try
+	{
+		const std::string &v = values.at(0);
+		if (key == "populationSize") applyList(values, config.populationSize, grid.populationSizes);
+		else if (key == "mutationRate") applyList(values, config.mutationRate, grid.mutationRates);
+		else if (key == "crossoverProportion") applyList(values, config.crossoverProportion, grid.crossoverProportions);
+		else if (key == "polynomialDegree") applyList(values, config.polynomialDegree, grid.polynomialDegrees);
+		else if (key == "maxGeneration") applyList(values, config.maxGeneration, grid.maxGenerations);
+		else if (key == "seed") applyList(values, config.seed, grid.seeds);
+		else if (key == "geneCodec") applyList(values, config.geneCodec, grid.geneCodecs);
+		else if (key == "minCoefficient") config.minCoefficient = parseValue<int>(v);
+		else if (key == "maxCoefficient") config.maxCoefficient = parseValue<int>(v);
+		else if (key == "pointMinX") config.pointMinX = parseValue<double>(v);
+		else if (key == "pointMaxX") config.pointMaxX = parseValue<double>(v);
+		else if (key == "pointMinY") config.pointMinY = parseValue<double>(v);
+		else if (key == "pointMaxY") config.pointMaxY = parseValue<double>(v);
+		else if (key == "positivePointsSize") config.positivePointsSize = parseValue<int>(v);
+		else if (key == "negativePointsSize") config.negativePointsSize = parseValue<int>(v);
+		else if (key == "useSampledFitness") config.useSampledFitness = parseBool(v);
+		else if (key == "fitnessSampleSize") config.fitnessSampleSize = parseValue<int>(v);
+		else if (key == "fullFitnessEvaluations") config.fullFitnessEvaluations = parseValue<int>(v);
+		else if (key == "fitnessConfidence") config.fitnessConfidence = parseValue<double>(v);
+		else if (key == "collectClassificationBits") config.collectClassificationBits = parseBool(v);
+		else if (key == "useFitnessCutoff") config.useFitnessCutoff = parseBool(v);
+		else if (key == "hardestPointsFirst") config.hardestPointsFirst = parseBool(v);
+		else if (key == "useCompiledEngine") config.useCompiledEngine = parseBool(v);
+		else if (key == "useBitmaskOperators") config.useBitmaskOperators = parseBool(v);
+		else if (key == "creepStep") config.creepStep = parseValue<int>(v);
+		else if (key == "timeBudget") config.timeBudget = parseValue<double>(v);
+		else if (key == "minPopulationSize") config.minPopulationSize = parseValue<int>(v);
+		else if (key == "pipelineThreads") config.pipelineThreads = parseValue<int>(v);
+		else if (key == "steadyState") config.steadyState = parseBool(v);
+		else if (key == "useMixedPrecision") config.useMixedPrecision = parseBool(v);
+		else if (key == "checkMixedPrecision") config.checkMixedPrecision = parseValue<int>(v);
+		else if (key == "pointCompaction") config.pointCompaction = trim(value);
+		else if (key == "autotune") config.autotune = parseBool(v);
+		else if (key == "autotuneProfile") config.autotuneProfile = trim(value);
+		else if (key == "forceStrategy") config.forceStrategy = trim(value);
+		else if (key == "metricsSocket") config.metricsSocket = trim(value);
+		else if (key == "metricsPort") config.metricsPort = parseValue<int>(v);
+		else if (key == "historyLog") config.historyLog = trim(value);
+		else if (key == "historyRead") config.historyRead = trim(value);
+		else if (key == "historyGeneration") config.historyGeneration = parseValue<int>(v);
+		else if (key == "plotTerminal") config.plotTerminal = trim(value);
+		else if (key == "plotRate") config.plotRate = parseValue<double>(v);
+		else if (key == "plotDirectory") config.plotDirectory = trim(value);
+		else if (key == "gnuplotPath") config.gnuplotPath = trim(value);
+		else if (key == "geneBits") config.geneBits = parseValue<int>(v);
+		else if (key == "fractionalBits") config.fractionalBits = parseValue<int>(v);
+		else if (key == "threads")
+		{
+			// Unset (0) uses every hardware thread, an explicit number has to be at least one
+			config.threads = parseValue<int>(v);
+			if (config.threads < 1)
+				throw std::invalid_argument(v);
+		}
+		else if (key == "onlineBatches") config.onlineBatches = parseValue<int>(v);
+		else if (key == "onlineBatchSize") config.onlineBatchSize = parseValue<int>(v);
+		else if (key == "checkpoint") config.checkpoint = trim(value);
+		else if (key == "serveSocket") config.serveSocket = trim(value);
+		else if (key == "classifyInput") config.classifyInput = trim(value);
+		else if (key == "classifyOutput") config.classifyOutput = trim(value);
+		else if (key == "classifyBinary") config.classifyBinary = parseBool(v);
+		else if (key == "classifyLabel") config.classifyLabel = parseValue<int>(v);
+		else if (key == "classifyChunkBytes") config.classifyChunkBytes = parseValue<int>(v);
+		else if (key == "batchProblems") config.batchProblems = parseValue<int>(v);
+		else if (key == "pointDistribution") config.pointDistribution = trim(value);
+		else if (key == "pointSigma") config.pointSigma = parseValue<double>(v);
+		else if (key == "pointMargin") config.pointMargin = parseValue<double>(v);
+		else if (key == "pointLabelNoise") config.pointLabelNoise = parseValue<double>(v);
+		else if (key == "pointCurve")
+		{
+			config.pointCurve.clear();
+			for (unsigned int i = 0; i < values.size(); i++)
+				config.pointCurve.push_back(parseValue<double>(values.at(i)));
+		}
+		else
+		{
+			std::cerr << "Unknown parameter " << key << std::endl;
+			return false;
+		}
+	}
+	catch (std::exception &)
+	{
+		std::cerr << "Invalid value " << value << " for " << key << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool parseConfigFile(const std::string &filename, RunConfig &config, SweepGrid &grid)
+{
+	std::ifstream inf(filename);
+	if (!inf)
+	{
+		std::cerr << "Cannot open " << filename << " for reading" << std::endl;
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(inf, line))
+	{
+		line = trim(line);
+		if (line.empty() || line.at(0) == '#')
+			continue;
+
+		size_t separator = line.find('=');
+		if (separator == std::string::npos)
+		{
+			std::cerr << "Invalid line in " << filename << ": " << line << std::endl;
+			return false;
+		}
+		if (!applyConfigValue(config, grid, trim(line.substr(0, separator)), line.substr(separator + 1)))
+			return false;
+	}
+	return true;
+}
+
+bool parseCommandLine(int argc, char *argv[], RunConfig &config, SweepGrid &grid)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "--help" || argument == "-h")
+		{
+			printUsage();
+			return false;
+		}
+		if (argument.compare(0, 2, "--") != 0)
+		{
+			std::cerr << "Unexpected argument " << argument << std::endl;
+			return false;
+		}
+
+		std::string key = argument.substr(2);
+		std::string value;
+		size_t separator = key.find('=');
+		if (separator != std::string::npos)
+		{
+			value = key.substr(separator + 1);
+			key = key.substr(0, separator);
+		}
+		else if (i + 1 < argc)
+			value = argv[++i];
+
+		bool isApplied = key == "config" ? parseConfigFile(value, config, grid) : applyConfigValue(config, grid, key, value);
+		if (!isApplied)
+			return false;
+	}
+	return validateConfig(config, grid);
+}
+
+// The smallest value of a parameter over the base config and its sweep dimension
+template <typename T>
+T minimumOf(const std::vector<T> &values, T baseValue)
+{
+	for (unsigned int i = 0; i < values.size(); i++)
+		baseValue = std::min(baseValue, values.at(i));
+	return baseValue;
+}
+
+bool validateConfig(const RunConfig &config, const SweepGrid &grid)
+{
+	if (minimumOf(grid.populationSizes, config.populationSize) <= 0)
+	{
+		std::cerr << "populationSize should be positive" << std::endl;
+		return false;
+	}
+	if (minimumOf(grid.polynomialDegrees, config.polynomialDegree) < 1)
+	{
+		std::cerr << "polynomialDegree should be at least 1" << std::endl;
+		return false;
+	}
+	if (minimumOf(grid.maxGenerations, config.maxGeneration) < 0)
+	{
+		std::cerr << "maxGeneration should not be negative" << std::endl;
+		return false;
+	}
+	if (config.positivePointsSize <= 0 || config.negativePointsSize <= 0)
+	{
+		std::cerr << "positivePointsSize and negativePointsSize should be positive" << std::endl;
+		return false;
+	}
+	// The Hoeffding radius of the sampled fitness divides by 1 - confidence
+	if (!(config.fitnessConfidence > 0.0 && config.fitnessConfidence < 1.0))
+	{
+		std::cerr << "fitnessConfidence should be in (0, 1)" << std::endl;
+		return false;
+	}
+	if (config.minCoefficient > config.maxCoefficient)
+	{
+		std::cerr << "minCoefficient should not be greater than maxCoefficient" << std::endl;
+		return false;
+	}
+	// The steady state run lives on the pipelined executor, which only computes plain fitness
+	if (config.steadyState && (config.pipelineThreads <= 0 || config.useSampledFitness || config.useFitnessCutoff ||
+		config.collectClassificationBits || config.useCompiledEngine))
+	{
+		std::cerr << "--steadyState=true needs --pipelineThreads and plain fitness of the generational engine" << std::endl;
+		return false;
+	}
+	// The pipelined executor breeds child by child in two's complement, with the probabilities of the packed
+	// operators of that codec only
+	std::vector<std::string> geneCodecs = grid.geneCodecs.empty() ? std::vector<std::string>{ config.geneCodec } : grid.geneCodecs;
+	// Only the packed operators know the other codecs, the child by child algorithm mutates two's complement bits
+	if (!config.useBitmaskOperators &&
+		std::count(geneCodecs.begin(), geneCodecs.end(), "twos") != static_cast<int>(geneCodecs.size()))
+	{
+		std::cerr << "--geneCodec other than twos needs --useBitmaskOperators=true" << std::endl;
+		return false;
+	}
+	if (config.pipelineThreads > 0 && config.useBitmaskOperators &&
+		std::count(geneCodecs.begin(), geneCodecs.end(), "twos") != static_cast<int>(geneCodecs.size()))
+	{
+		std::cerr << "--pipelineThreads breeds in two's complement, other gene codecs need --pipelineThreads=0" << std::endl;
+		return false;
+	}
+	// The packed operators keep a gene in 8 bits
+	if (config.useBitmaskOperators && !config.useCompiledEngine && (config.minCoefficient < -128 || config.maxCoefficient > 127))
+	{
+		std::cerr << "Coefficients of --useBitmaskOperators should be in [-128, 127]" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool isSweep(SweepGrid &grid)
+{
+	return grid.populationSizes.size() > 1 || grid.mutationRates.size() > 1 || grid.crossoverProportions.size() > 1 ||
+		grid.polynomialDegrees.size() > 1 || grid.maxGenerations.size() > 1 || grid.seeds.size() > 1 ||
+		grid.geneCodecs.size() > 1;
+}
+
+// Empty dimension is replaced by the single base value
+template <typename T>
+std::vector<T> dimensionOf(const std::vector<T> &values, T baseValue)
+{
+	return values.empty() ? std::vector<T>{ baseValue } : values;
+}
+
+std::vector<RunConfig> expandGrid(const RunConfig &base, SweepGrid &grid)
+{
+	std::vector<RunConfig> configs;
+	for (int populationSize : dimensionOf(grid.populationSizes, base.populationSize))
+		for (double mutationRate : dimensionOf(grid.mutationRates, base.mutationRate))
+			for (double crossoverProportion : dimensionOf(grid.crossoverProportions, base.crossoverProportion))
+				for (int polynomialDegree : dimensionOf(grid.polynomialDegrees, base.polynomialDegree))
+					for (int maxGeneration : dimensionOf(grid.maxGenerations, base.maxGeneration))
+						for (unsigned int seed : dimensionOf(grid.seeds, base.seed))
+							for (const std::string &geneCodec : dimensionOf(grid.geneCodecs, base.geneCodec))
+							{
+								RunConfig config = base;
+								config.populationSize = populationSize;
+								config.mutationRate = mutationRate;
+								config.crossoverProportion = crossoverProportion;
+								config.polynomialDegree = polynomialDegree;
+								config.maxGeneration = maxGeneration;
+								config.seed = seed;
+								config.geneCodec = geneCodec;
+								configs.push_back(config);
+							}
+	return configs;
+}
+
+void printUsage()
+{
+	std::cout << "Usage: AI_Lab1 [--config=file] [--key=value ...]\n"
+		<< "Any parameter may be given as --key=value or as a \"key = value\" line of the config file.\n"
+		<< "A comma separated list for populationSize, mutationRate, crossoverProportion, polynomialDegree,\n"
+		<< "maxGeneration or seed runs a parameter sweep over all combinations on --threads workers.\n"
+		<< "--onlineBatches=N streams N batches of --onlineBatchSize new points into a warm-started population.\n"
+		<< "--checkpoint=file saves the best curve, with --serveSocket=path the curve from the checkpoint is served.\n"
+		<< "--classifyInput=file classifies a point file by the checkpoint curve (--classifyOutput, --classifyBinary,\n"
+		<< "--classifyLabel=0|1 for the known label of all points, --classifyChunkBytes).\n"
+		<< "--batchProblems=N solves N random problems of up to the configured point counts on one thread pool.\n"
+		<< "--pointDistribution=split|gaussian|curve generates the point sets in parallel (--pointSigma,\n"
+		<< "--pointCurve=a,b,c with --pointMargin for the curve layout, --pointLabelNoise).\n"
+		<< "--useBitmaskOperators=false breeds child by child instead of the packed whole-generation pass.\n"
+		<< "--geneCodec=twos|gray|offset|creep selects the gene encoding of that pass (--creepStep for creep),\n"
+		<< "a list of codecs sweeps them and reports generations to solution per codec.\n"
+		<< "--timeBudget=seconds stops every run at its deadline with the best curve so far, the population\n"
+		<< "shrinks down to --minPopulationSize when the remaining generations would not fit.\n"
+		<< "--historyLog=file records genomes, fitness and parents of every generation (one file per job,\n"
+		<< "suffixed by the job number in sweeps and batches), --historyRead=file prints the recorded runs or with\n"
+		<< "--historyGeneration=N the individuals of generation N.\n"
+		<< "--plotTerminal=window|png|svg|script|none chooses how the run is plotted, images and scripts are written\n"
+		<< "to --plotDirectory. --plotRate=N also plots the running fitness and best curve at most N times per second\n"
+		<< "on a background thread, frames are dropped when gnuplot falls behind. --gnuplotPath sets the gnuplot command.\n"
+		<< "--pipelineThreads=N evaluates children on N worker threads while the next ones are bred child by child\n"
+		<< "(two's complement genes and plain fitness only, not with sampled fitness, cutoff or classification bits).\n"
+		<< "With --steadyState=true the generation barrier\n"
+		<< "is dropped: each evaluated child replaces the worst individual, a generation is populationSize children.\n"
+		<< "--useMixedPrecision=true classifies points in float32 and re-tests in double only the points closer to the\n"
+		<< "curve than the rounding error bound, the fitness is the same as in double (plain fitness and pipeline).\n"
+		<< "--checkMixedPrecision=N compares both precisions on N random curves (reproducible with --seed) and exits.\n"
+		<< "--pointCompaction=exact merges duplicate points into weighted points, =lattice also merges points with the same\n"
+		<< "dyadic x whose y no integer coefficient curve can separate. Fitness stays the same; not used with sampled\n"
+		<< "fitness, classification bits, the compiled engine or online batches.\n"
+		<< "--autotune=true times both fitness precisions, sequential and pipelined on 1, 2, 4, ... threads on a sample of\n"
+		<< "the points before a single run and uses the fastest; the choice is cached per host and problem shape in\n"
+		<< "--autotuneProfile. --forceStrategy=scalar|mixed[:threads] skips the profiling (plain fitness only).\n"
+		<< "--metricsSocket=path or --metricsPort=N serves generations, evaluations, points tested, phase times, mixed\n"
+		<< "precision hit ratio, best fitness and resident memory of a single run in the Prometheus text format over HTTP\n"
+		<< "on a Unix domain socket or on 127.0.0.1 (Linux only).\n";
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include "stdafx.h"
+#include <string>
+#include <vector>
+
+// Parameters of one genetic algorithm run, defaults are the former compile-time constants
+struct RunConfig
+{
+	int minCoefficient = -127;
+	int maxCoefficient = 127;
+	double pointMinX = -20;
+	double pointMaxX = 20;
+	double pointMinY = -10;
+	double pointMaxY = 10;
+	int populationSize = 30;
+	int positivePointsSize = 100;
+	int negativePointsSize = 100;
+	double crossoverProportion = 0.5;
+	double mutationRate = 1.0;
+	int maxGeneration = 100;
+	int polynomialDegree = 2;
+	bool useSampledFitness = false;
+	int fitnessSampleSize = 64;
+	int fullFitnessEvaluations = 5;
+	double fitnessConfidence = 0.95;
+	bool collectClassificationBits = false;
+	bool useFitnessCutoff = false;
+	bool hardestPointsFirst = true;
+	bool useCompiledEngine = false;
+	bool useBitmaskOperators = true;
+	bool useMixedPrecision = false;
+	std::string geneCodec = "twos";
+	int creepStep = 4;
+	double timeBudget = 0.0;
+	int minPopulationSize = 10;
+	int pipelineThreads = 0;
+	bool steadyState = false;
+	std::string historyLog;
+	std::string historyRead;
+	int historyGeneration = -1;
+	std::string plotTerminal = "window";
+	double plotRate = 0.0;
+	std::string plotDirectory = ".";
+#ifdef _WIN32
+	std::string gnuplotPath = "\"C:\\gnuplot\\bin\\gnuplot.exe\"";
+#else
+	std::string gnuplotPath = "gnuplot";
+#endif
+	int geneBits = 8;
+	int fractionalBits = 0;
+	unsigned int seed = 0;
+	int threads = 0;
+	int onlineBatches = 0;
+	int onlineBatchSize = 10;
+	std::string checkpoint;
+	std::string serveSocket;
+	std::string classifyInput;
+	std::string classifyOutput;
+	bool classifyBinary = false;
+	int classifyLabel = -1;
+	int classifyChunkBytes = 16 << 20;
+	int batchProblems = 0;
+	std::string pointDistribution;
+	std::string pointCompaction = "none";
+	bool autotune = false;
+	std::string autotuneProfile = "AutotuneProfile.dat";
+	std::string forceStrategy;
+	std::string metricsSocket;
+	int metricsPort = 0;
+	double pointSigma = 3.0;
+	std::vector<double> pointCurve = { 0.0, 0.0 };
+	double pointMargin = 0.0;
+	double pointLabelNoise = 0.0;
+	int checkMixedPrecision = 0;
+};
+
+// Values of the swept parameters, an empty dimension keeps the value of the base config
+struct SweepGrid
+{
+	std::vector<int> populationSizes;
+	std::vector<double> mutationRates;
+	std::vector<double> crossoverProportions;
+	std::vector<int> polynomialDegrees;
+	std::vector<int> maxGenerations;
+	std::vector<unsigned int> seeds;
+	std::vector<std::string> geneCodecs;
+};
+
+// Sets one parameter by name. A comma separated list of values for a sweepable parameter
+// (populationSize, mutationRate, crossoverProportion, polynomialDegree, maxGeneration, seed, geneCodec) adds a sweep dimension
+bool applyConfigValue(RunConfig &config, SweepGrid &grid, const std::string &key, const std::string &value);
+
+// Reads "key = value" lines, empty lines and lines starting with # are skipped
+bool parseConfigFile(const std::string &filename, RunConfig &config, SweepGrid &grid);
+
+// Reads "--key=value" or "--key value" arguments, "--config=file" loads a config file at that position
+bool parseCommandLine(int argc, char *argv[], RunConfig &config, SweepGrid &grid);
+
+// Checks combinations the parsing of single values can not: positive population, degree at least 1,
+// a non-empty coefficient range which fits the 8-bit genes of the packed operators, over all sweep values,
+// a steady state run only where the pipelined executor runs, and no other gene codec than two's complement with it
+bool validateConfig(const RunConfig &config, const SweepGrid &grid);
+
+// True when at least one parameter has more than one value
+bool isSweep(SweepGrid &grid);
+
+// Cartesian product of the grid applied on top of the base config
+std::vector<RunConfig> expandGrid(const RunConfig &base, SweepGrid &grid);
+
+void printUsage();
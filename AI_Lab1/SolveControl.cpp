@@ -0,0 +1,70 @@
+#include "stdafx.h"
+#include "SolveControl.h"
+#include <algorithm>
+#include <limits>
+
+// Control without deadline, stops only when cancelled
+SolveControl::SolveControl() : m_hasDeadline(false), m_isCancelled(false), m_parent(nullptr)
+{
+	m_start = m_deadline = std::chrono::steady_clock::now();
+}
+
+// Deadline in the given number of seconds from now, no deadline when seconds is not positive
+SolveControl::SolveControl(double seconds, const SolveControl *parent)
+	: m_hasDeadline(seconds > 0), m_isCancelled(false), m_parent(parent)
+{
+	m_start = std::chrono::steady_clock::now();
+	m_deadline = m_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double>(std::max(seconds, 0.0)));
+}
+
+SolveControl::~SolveControl()
+{
+
+}
+
+void SolveControl::cancel()
+{
+	m_isCancelled.store(true, std::memory_order_relaxed);
+}
+
+// Withdraws an earlier cancel, so that the control can be used for the next run
+void SolveControl::reset()
+{
+	m_isCancelled.store(false, std::memory_order_relaxed);
+}
+
+bool SolveControl::isCancelled() const
+{
+	return m_isCancelled.load(std::memory_order_relaxed) || (m_parent != nullptr && m_parent->isCancelled());
+}
+
+bool SolveControl::shouldStop() const
+{
+	if (isCancelled())
+		return true;
+	if (m_hasDeadline && std::chrono::steady_clock::now() >= m_deadline)
+		return true;
+	return m_parent != nullptr && m_parent->shouldStop();
+}
+
+bool SolveControl::hasDeadline() const
+{
+	return m_hasDeadline || (m_parent != nullptr && m_parent->hasDeadline());
+}
+
+double SolveControl::getElapsedSeconds() const
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+// Seconds until the nearest deadline of this control and its parents, infinity without any deadline
+double SolveControl::getRemainingSeconds() const
+{
+	double remaining = std::numeric_limits<double>::infinity();
+	if (m_hasDeadline)
+		remaining = std::chrono::duration<double>(m_deadline - std::chrono::steady_clock::now()).count();
+	if (m_parent != nullptr)
+		remaining = std::min(remaining, m_parent->getRemainingSeconds());
+	return remaining;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "stdafx.h"
+#include <atomic>
+#include <chrono>
+
+// Deadline and cooperative cancellation of an anytime run. The run polls shouldStop between individuals,
+// cancel may be called from any thread. A control may have a parent (for example the whole batch),
+// then it also stops when the parent is cancelled or past its deadline
+class SolveControl
+{
+	std::chrono::steady_clock::time_point m_start;
+	std::chrono::steady_clock::time_point m_deadline;
+	bool m_hasDeadline;
+	std::atomic<bool> m_isCancelled;
+	const SolveControl *m_parent;
+
+public:
+	SolveControl();
+	SolveControl(double seconds, const SolveControl *parent);
+	void cancel();
+	void reset();
+	bool isCancelled() const;
+	bool shouldStop() const;
+	bool hasDeadline() const;
+	double getElapsedSeconds() const;
+	double getRemainingSeconds() const;
+	~SolveControl();
+};
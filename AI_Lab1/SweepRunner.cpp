@@ -0,0 +1,83 @@
+#include "stdafx.h"
+#include "SweepRunner.h"
+#include "BatchSolver.h"
+#include <algorithm>
+
+std::vector<SweepRow> runSweep(std::vector<RunConfig> &configs, PointSet &positiveSet, PointSet &negativeSet, int threads)
+{
+	std::vector<SolveProblem> problems;
+	for (unsigned int i = 0; i < configs.size(); i++)
+	{
+		SolveProblem problem{ configs.at(i), &positiveSet, &negativeSet };
+
+		// Shared point sets must stay in their original order
+		problem.config.hardestPointsFirst = false;
+		if (!problem.config.historyLog.empty())
+			problem.config.historyLog += "." + std::to_string(i);
+		problems.push_back(problem);
+	}
+
+	BatchSolver solver(threads);
+	std::vector<SolveOutcome> outcomes = solver.solveAll(problems);
+
+	std::vector<SweepRow> rows;
+	for (unsigned int i = 0; i < problems.size(); i++)
+		rows.push_back(SweepRow{ problems.at(i).config, outcomes.at(i).result, outcomes.at(i).seconds });
+	return rows;
+}
+
+void printSweepTable(std::vector<SweepRow> &rows, std::ostream &out)
+{
+	out << "populationSize\tmutationRate\tcrossoverProportion\tpolynomialDegree\tmaxGeneration\tseed\tgeneCodec\t"
+		<< "bestFitness\tbestGeneration\tgenerations\tseconds\tbestCoefficients\n";
+
+	for (unsigned int i = 0; i < rows.size(); i++)
+	{
+		SweepRow &row = rows.at(i);
+		out << row.config.populationSize << '\t' << row.config.mutationRate << '\t' << row.config.crossoverProportion << '\t'
+			<< row.config.polynomialDegree << '\t' << row.config.maxGeneration << '\t' << row.config.seed << '\t'
+			<< row.config.geneCodec << '\t'
+			<< row.result.bestFitness << '\t' << row.result.bestGeneration << '\t' << row.result.generations << '\t'
+			<< row.seconds << '\t';
+		for (unsigned int m = 0; m < row.result.bestCoefficients.size(); m++)
+			out << (m == 0 ? "" : " ") << row.result.bestCoefficients.at(m);
+		out << '\n';
+	}
+}
+
+void printCodecSummary(std::vector<SweepRow> &rows, std::ostream &out)
+{
+	std::vector<std::string> codecs;
+	for (unsigned int i = 0; i < rows.size(); i++)
+		if (std::find(codecs.begin(), codecs.end(), rows.at(i).config.geneCodec) == codecs.end())
+			codecs.push_back(rows.at(i).config.geneCodec);
+
+	out << "geneCodec\truns\tsolved\tavgGenerationsToSolution\tavgEvaluationsToSolution\tavgBestFitness\n";
+	for (unsigned int c = 0; c < codecs.size(); c++)
+	{
+		int runs = 0, solved = 0;
+		double generations = 0.0, evaluations = 0.0, fitness = 0.0;
+		for (unsigned int i = 0; i < rows.size(); i++)
+		{
+			SweepRow &row = rows.at(i);
+			if (row.config.geneCodec != codecs.at(c))
+				continue;
+
+			runs++;
+			fitness += row.result.bestFitness;
+			if (row.result.bestFitness == 1.00)
+			{
+				solved++;
+				generations += row.result.generations;
+				evaluations += row.result.evaluations;
+			}
+		}
+
+		out << codecs.at(c) << '\t' << runs << '\t' << solved << '\t';
+		if (solved > 0)
+			out << generations / solved << '\t' << evaluations / solved << '\t';
+		else
+			out << "-\t-\t";
+		out << fitness / runs << '\n';
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "stdafx.h"
+#include "GeneticAlgorithm.h"
+#include "PointSet.h"
+#include "RunConfig.h"
+#include <ostream>
+#include <vector>
+
+// Result of one sweep job
+struct SweepRow
+{
+	RunConfig config;
+	RunResult result;
+	double seconds;
+};
+
+// Runs all configurations concurrently on a shared thread pool. Every job reads the same point sets
+// and seeds the generator of its worker thread with the job seed
+std::vector<SweepRow> runSweep(std::vector<RunConfig> &configs, PointSet &positiveSet, PointSet &negativeSet, int threads);
+
+// Writes tab separated table with one line per job
+void printSweepTable(std::vector<SweepRow> &rows, std::ostream &out);
+
+// Writes per gene codec number of solved runs (best fitness 1) and their average generations
+// and fitness evaluations to solution
+void printCodecSummary(std::vector<SweepRow> &rows, std::ostream &out);
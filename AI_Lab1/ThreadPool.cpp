@@ -0,0 +1,71 @@
+#include "stdafx.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+// Starts threadNum workers, zero or negative means one per hardware thread
+ThreadPool::ThreadPool(int threadNum) : m_activeTasks(0), m_isStopping(false)
+{
+	if (threadNum <= 0)
+		threadNum = std::max(1u, std::thread::hardware_concurrency());
+
+	for (int i = 0; i < threadNum; i++)
+		m_workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+}
+
+void ThreadPool::workerLoop()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_taskReady.wait(lock, [this] { return m_isStopping || !m_tasks.empty(); });
+			if (m_tasks.empty())
+				return;
+			task = std::move(m_tasks.front());
+			m_tasks.pop();
+			m_activeTasks++;
+		}
+
+		task();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_activeTasks--;
+			if (m_activeTasks == 0 && m_tasks.empty())
+				m_allDone.notify_all();
+		}
+	}
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push(std::move(task));
+	}
+	m_taskReady.notify_one();
+}
+
+// Blocks until every submitted task has finished
+void ThreadPool::wait()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_allDone.wait(lock, [this] { return m_activeTasks == 0 && m_tasks.empty(); });
+}
+
+int ThreadPool::getThreadNum()
+{
+	return m_workers.size();
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStopping = true;
+	}
+	m_taskReady.notify_all();
+	for (unsigned int i = 0; i < m_workers.size(); i++)
+		m_workers.at(i).join();
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "stdafx.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads executing submitted tasks in FIFO order
+class ThreadPool
+{
+	std::vector<std::thread> m_workers;
+	std::queue<std::function<void()>> m_tasks;
+	std::mutex m_mutex;
+	std::condition_variable m_taskReady;
+	std::condition_variable m_allDone;
+	int m_activeTasks;
+	bool m_isStopping;
+
+	void workerLoop();
+
+public:
+	ThreadPool(int threadNum);
+	void submit(std::function<void()> task);
+	void wait();
+	int getThreadNum();
+	~ThreadPool();
+};
@@ -48,3 +48,75 @@
 //for (unsigned int i = 0; i < bits.size(); i++)
 //	std::cout << bits.at(i);
 //std::cout << ", decimal = " << num << '\n';
+
+#include "Curve.h"
+#include "Functions.h"
+#include "Point.h"
+#include "PointSet.h"
+#include "RandomNumberGenerator.h"
+#include "RunConfig.h"
+#include <cmath>
+
+// Point on the curve in double, highest power first as in the curve functions
+double getCurveValue(const Curve &curve, double x)
+{
+	ConstView<const Coefficient*> c = curve.getCoefficients();
+	double y = 0;
+	for (unsigned int k = 0; k < c.size(); k++)
+		y = y * x + c[k]->getNumber();
+	return y;
+}
+
+// Mixed precision fitness has to equal the double fitness for every curve. Random curves of every degree are
+// tested on points on the curve, a few double ulps and a few float32 ulps above and below it, where the float32
+// pass is least sure, and on random points of the configured area. The same seed checks the same curves.
+// Prints and returns the number of curves whose fitnesses differ
+int checkMixedPrecision(const RunConfig &config, int curveNum)
+{
+	const int pointsPerCurve = 64;
+	const double floatUlp = 0x1p-24;
+	int mismatches = 0;
+	MixedPrecisionCounts counts;
+
+	for (int i = 0; i < curveNum; i++)
+	{
+		int degree = 1 + i % 5;
+		Curve curve(degree, config.minCoefficient, config.maxCoefficient);
+		PointSet positiveSet(true);
+		PointSet negativeSet(false);
+		PointSet emptyPositiveSet(true);
+		PointSet emptyNegativeSet(false);
+
+		for (int p = 0; p < pointsPerCurve; p++)
+		{
+			// Every other x is exact in float32, so the float32 pass sees the same x as the double test
+			double x = getRandomNumber(config.pointMinX, config.pointMaxX);
+			if (p % 2 == 0)
+				x = static_cast<float>(x);
+			double y = getCurveValue(curve, x);
+			double nearY[] = { y, nextafter(y, INFINITY), nextafter(y, -INFINITY), y + 4 * fabs(y) * 0x1p-52,
+				y - 4 * fabs(y) * 0x1p-52, y * (1 + floatUlp), y * (1 - floatUlp), y * (1 + 16 * floatUlp), y * (1 - 16 * floatUlp),
+				getRandomNumber(config.pointMinY, config.pointMaxY) };
+			for (double pointY : nearY)
+			{
+				positiveSet.addPoint(Point(x, pointY));
+				negativeSet.addPoint(Point(x, pointY));
+			}
+		}
+
+		// Each set on its own, so that errors on both sides can not cancel out
+		bool isEqual = calculateMixedFitness(curve, positiveSet, emptyNegativeSet, &counts) == calculateFitness(curve, positiveSet, emptyNegativeSet) &&
+			calculateMixedFitness(curve, emptyPositiveSet, negativeSet, &counts) == calculateFitness(curve, emptyPositiveSet, negativeSet);
+		if (!isEqual)
+		{
+			mismatches++;
+			std::cout << "Mixed precision fitness differs for curve ";
+			curve.printCoefficients();
+		}
+	}
+
+	std::cout << "Checked " << curveNum << " curves, " << mismatches << " mixed precision mismatches, "
+		<< counts.retestedPoints.load() << " of " << counts.testedPoints.load()
+		<< " points retested in double" << std::endl;
+	return mismatches;
+}